@@ -90,5 +90,85 @@ public:
 
 };
 
+
+/**
+ * Compile-time variant of TouchPanel. A driver derives from
+ * StaticTouchPanel<Driver> and implements the same methods as TouchPanel
+ * without virtual. Generic code takes a StaticTouchPanel<Panel>& and calls
+ * the methods on panel(), so all calls are resolved at compile time and
+ * no vtable is involved.
+ *
+ * The base has no methods of the TouchPanel names itself: a forwarder
+ * would call itself if the driver missed the method. panel() checks
+ * instead that the driver implements all of them, which also allows
+ * additional parameters with default values and further read() overloads.
+ */
+template <class Panel>
+class StaticTouchPanel {
+public:
+
+    Panel& panel()
+    {
+        static_assert(sizeof(probe().init((uint16_t)0, (uint16_t)0)) == sizeof(bool),
+                      "Panel must implement bool init(uint16_t width, uint16_t height)");
+        static_assert(sizeof(probe().read(probeCoord())) == sizeof(bool),
+                      "Panel must implement bool read(TouchPanel::touchCoordinate_t &coord)");
+        static_assert(sizeof(probe().calibrateStart()) == sizeof(bool),
+                      "Panel must implement bool calibrateStart()");
+        static_assert(sizeof(probe().getNextCalibratePoint((uint16_t*)0, (uint16_t*)0)) == sizeof(bool),
+                      "Panel must implement bool getNextCalibratePoint(uint16_t* x, uint16_t* y)");
+        static_assert(sizeof(probe().waitForCalibratePoint((bool*)0, (uint32_t)0)) == sizeof(bool),
+                      "Panel must implement bool waitForCalibratePoint(bool* morePoints, uint32_t timeout)");
+        return static_cast<Panel&>(*this);
+    }
+
+private:
+
+    // only used unevaluated by the checks in panel(), never defined
+    static Panel& probe();
+    static TouchPanel::touchCoordinate_t& probeCoord();
+};
+
+
+/**
+ * Adapter which exposes a StaticTouchPanel driver through the virtual
+ * TouchPanel interface, for code that needs runtime polymorphism.
+ */
+template <class Panel>
+class TouchPanelAdapter : public TouchPanel {
+public:
+
+    TouchPanelAdapter(Panel &panel) : _panel(panel) {}
+
+    virtual bool init(uint16_t width, uint16_t height)
+    {
+        return _panel.init(width, height);
+    }
+
+    virtual bool read(touchCoordinate_t &coord)
+    {
+        return _panel.read(coord);
+    }
+
+    virtual bool calibrateStart()
+    {
+        return _panel.calibrateStart();
+    }
+
+    virtual bool getNextCalibratePoint(uint16_t* x, uint16_t* y)
+    {
+        return _panel.getNextCalibratePoint(x, y);
+    }
+
+    virtual bool waitForCalibratePoint(bool* morePoints, uint32_t timeout)
+    {
+        return _panel.waitForCalibratePoint(morePoints, timeout);
+    }
+
+private:
+
+    Panel &_panel;
+};
+
 #endif
 
@@ -72,29 +72,236 @@ void AR1021::debug(const char *text,int16_t zahl)
   }
 }
 
+/**
+ * Advance the time base of the driver. Call this from a 1 ms timer
+ * interrupt; the ticks are used to timestamp recorded traffic.
+ */
+void AR1021::tick()
+{
+  _ticks++;
+  _ticking = true;
+}
+
+uint16_t AR1021::ticks()
+{
+  uint16_t t;
+  // 16-bit read is not atomic on AVR, read again if a tick came in between
+  do {
+    t = _ticks;
+  } while (t != _ticks);
+  return t;
+}
+
+void AR1021::setRecorder(TouchRecorder *recorder)
+{
+  _recorder = recorder;
+}
+
+/**
+ * Publish every decoded packet to the dispatcher. Its subscribers in
+ * TOUCH_DISPATCH_ISR mode run in the context of readTouchIrq().
+ *
+ * readTouchIrq() is the only caller of publish() then, so the dispatcher
+ * must not be published to from anywhere else. Recordings replayed
+ * through the driver on the host (host/driverReplay.h) reach it through
+ * readTouchIrq() as well.
+ */
+void AR1021::setDispatcher(TouchDispatcher *dispatcher)
+{
+  _dispatcher = dispatcher;
+}
+
+/**
+ * Correct every decoded packet with the mesh, see
+ * TouchDecoder::setCorrection().
+ */
+void AR1021::setCorrection(TouchCorrection *correction)
+{
+  _decoder.setCorrection(correction);
+}
+
+void AR1021::dumpRecording()
+{
+  char text[2*AR1021_DUMP_BYTES+1];
+
+  if (_recorder == NULL || _debugCom == NULL) return;
+
+  const uint8_t *data = _recorder->data();
+  uint16_t len = _recorder->length();
+  for (uint16_t pos = 0; pos < len; pos += AR1021_DUMP_BYTES) {
+    uint8_t n = (len - pos < AR1021_DUMP_BYTES) ? len - pos : AR1021_DUMP_BYTES;
+    touchHexEncode(&data[pos], n, text);
+    debug(text);
+  }
+}
+
 bool AR1021::read(touchCoordinate_t &coord)
 {
+  uint8_t seq;
 
   if (!_initialized) return false;
 
   //coord.x = (actual.x * _width)/4095;
   //coord.y = (actual.y * _height)/4095;
-  coord.x = actual.x;
-  coord.y = actual.y;
-  coord.touched = actual.touched;
-  if( compareCoord(actual,lastActual) )
+  if (!snapshot(coord, &seq))
+    return false;
+  if( compareCoord(coord,lastActual) )
+    return false;
+
+  // pen down and pen up are always reported, moves may be coalesced
+  if (!_coalescer.accept(coord.x, coord.y, coord.touched, seq, ticks(), _ticking))
+    return false;
+
+  lastActual.x = coord.x;
+  lastActual.y = coord.y;
+  lastActual.touched = coord.touched;
+  return true;
+}
+
+/**
+ * Configure the coalescing of moves in read(), see
+ * TouchCoalescer::configure(); times are in ms. Pen down and pen up are
+ * never delayed.
+ *
+ * The time based settings need tick() to be called, they are ignored
+ * until the first tick. Only read() is coalesced: readSample() and the
+ * dispatcher get every decoded packet.
+ */
+void AR1021::setCoalescing(uint8_t minDistance, uint16_t minInterval, uint16_t maxLatency)
+{
+  _coalescer.configure(minDistance, minInterval, maxLatency);
+}
+
+/**
+ * @return number of moves discarded by read() because of the coalescing
+ */
+uint16_t AR1021::suppressedEvents()
+{
+  return _coalescer.suppressed;
+}
+
+/**
+ * Read in the format of the TouchPanel interface. z is 1 while the panel
+ * is touched and 0 otherwise.
+ *
+ * @return true if the coordinates changed since the last read
+ */
+bool AR1021::read(TouchPanel::touchCoordinate_t &coord)
+{
+  touchCoordinate_t c;
+  bool changed = read(c);
+  coord.x = c.x;
+  coord.y = c.y;
+  coord.z = c.touched ? 1 : 0;
+  return changed;
+}
+
+/**
+ * Get a consistent copy of the actual coordinates without disabling
+ * interrupts. The copy is retried if readTouchIrq() updated the
+ * coordinates in between.
+ *
+ * @param seq if not NULL, the sequence value of the copy is written to it
+ *
+ * @return true if a consistent copy was made within AR1021_SEQ_RETRIES
+ * attempts; otherwise false
+ */
+bool AR1021::snapshot(touchCoordinate_t &coord, uint8_t *seq)
+{
+  for (uint8_t i = 0; i < AR1021_SEQ_RETRIES; i++) {
+    uint8_t s;
+    if (!_seqLock.readBegin(s)) continue;
+    coord.x = actual.x;
+    coord.y = actual.y;
+    coord.touched = actual.touched;
+    if (!_seqLock.readRetry(s)) {
+      if (seq != NULL) *seq = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Current value of the sequence counter, it advances by 2 with every
+ * decoded packet.
+ */
+uint8_t AR1021::sequence()
+{
+  return _seqLock.sequence();
+}
+
+/**
+ * Wait until a packet was decoded after the sequence value in seq was
+ * taken. The CPU sleeps in idle mode while waiting, so readTouchIrq()
+ * must be called from the interrupt of the SIQ pin.
+ *
+ * @param seq sequence value to compare with, updated to the new value
+ * @param timeout maximum number of milliseconds to wait. Set this argument
+ * to 0 to wait indefinite.
+ *
+ * @return true if the sequence advanced; false on timeout
+ */
+bool AR1021::waitForChange(uint8_t *seq, uint32_t timeout)
+{
+  if (seq == NULL) return false;
+
+  _timeoutTimer->value = timeout;
+  _timeoutTimer->state = TM_START;
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while ( (_seqLock.sequence() == *seq) || (_seqLock.sequence() & 1) ) {
+    if (timeout > 0 && _timeoutTimer->state == TM_STOP)
+      return false;
+
+    // the check and sleep_cpu() must not be separated by an interrupt,
+    // the instruction following sei() is always executed
+    cli();
+    if (_seqLock.sequence() == *seq) {
+      sleep_enable();
+      sei();
+      sleep_cpu();
+      sleep_disable();
+    }
+    sei();
+  }
+  *seq = _seqLock.sequence();
+  return true;
+}
+
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+/**
+ * Read the latest sample including raw and fixed-point coordinates. The
+ * coalescing of read() does not apply, every changed sample is returned.
+ *
+ * @return true if the sample differs from the one returned by the
+ * previous call; otherwise false
+ */
+bool AR1021::readSample(touchSample_t &sample)
+{
+  if (!_initialized) return false;
+
+  uint8_t i;
+  for (i = 0; i < AR1021_SEQ_RETRIES; i++) {
+    uint8_t seq;
+    if (!_seqLock.readBegin(seq)) continue;
+    sample = actualSample;
+    if (!_seqLock.readRetry(seq)) break;
+  }
+  if (i == AR1021_SEQ_RETRIES)
+    return false;
+
+  if( (sample.rawX==lastSample.rawX) && (sample.rawY==lastSample.rawY) && (sample.touched==lastSample.touched) )
     return false;
   else
   {
-    lastActual.x = actual.x;
-    lastActual.y = actual.y;
-    lastActual.touched = actual.touched;
+    lastSample = sample;
     return true;
   }
 }
+#endif
 
-
-bool AR1021::init(uint16_t width, uint16_t height, bool rotated = false)
+bool AR1021::init(uint16_t width, uint16_t height, bool rotated)
 {
     int result = 0;
     bool ok = false;
@@ -103,6 +310,7 @@ bool AR1021::init(uint16_t width, uint16_t height, bool rotated = false)
     _width = width;
     _height = height;
     _rotated = rotated;
+    _decoder.init(width, height, rotated);
     while (1) {
 
         do {
@@ -470,7 +678,13 @@ int AR1021::cmd(char cmd, char* data, int len, char* respBuf, int* respLen,bool
         spiDevice::unselect(); // _cs = 1;
     }
 
-
+    // readTouchIrq() records from the interrupt into the same buffer
+    if (_recorder != NULL) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            _recorder->recordCommand(ticks(), cmd, ret, (const uint8_t*)respBuf,
+                    (ret == 0 && respLen != NULL) ? *respLen : 0);
+        }
+    }
 
     return ret;
 }
@@ -533,9 +747,15 @@ int AR1021::waitForCalibResponse(uint32_t timeout) {
     return ret;
 }
 
-
+/**
+ * Read a touch packet. Must only be called from the touch interrupt, it
+ * is the single writer of actual and of the sequence counter. On the host
+ * recorded packets are replayed through here over a simulated SPI bus.
+ */
 void AR1021::readTouchIrq()
 {
+    uint8_t packet[AR1021_PACKET_SIZE];
+
     //while(_siq.read() == 1)
     while(AR1021_INT_PORT.IN & AR1021_INT_PIN)
     {
@@ -544,48 +764,51 @@ void AR1021::readTouchIrq()
         _delay_us(50);
 
         // touch coordinates are sent in a 5-byte data packet
+        for (uint8_t i = 0; i < AR1021_PACKET_SIZE; i++) {
+            packet[i] = transceiveByte(0); // _spi.write(0);
+            _delay_us(50);
+        }
 
-        int pen = transceiveByte(0); // _spi.write(0);
-        _delay_us(50);
+        spiDevice::unselect(); //_cs = 1;
 
-        int xlo = transceiveByte(0); // _spi.write(0);
-        _delay_us(50);
+        if (_recorder != NULL)
+            _recorder->recordPacket(ticks(), packet);
 
-        int xhi = transceiveByte(0); // _spi.write(0);
-        _delay_us(50);
-
-        int ylo = transceiveByte(0); // _spi.write(0);
-        _delay_us(50);
+        decodePacket(packet);
+    }
+}
 
-        int yhi = transceiveByte(0); // _spi.write(0);
-        _delay_us(50);
+/**
+ * Decode a 5-byte touch packet into the actual coordinates. Only called
+ * by readTouchIrq(), the sequence counter allows a single writer.
+ *
+ * @return true if the packet was valid; otherwise false
+ */
+bool AR1021::decodePacket(const uint8_t *packet)
+{
+    touchDecoded_t decoded;
 
-        spiDevice::unselect(); //_cs = 1;
+    if (!_decoder.decode(packet, decoded))
+        return false;
 
+    // readers retry while the sequence counter is odd or has changed
+    _seqLock.writeBegin();
+    actual.x = decoded.x;
+    actual.y = decoded.y;
+    actual.touched = decoded.touched;
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+    actualSample.rawX = decoded.rawX;
+    actualSample.rawY = decoded.rawY;
+    actualSample.x = decoded.xq;
+    actualSample.y = decoded.yq;
+    actualSample.touched = decoded.touched;
+#endif
+    _seqLock.writeEnd();
+
+    if (_dispatcher != NULL)
+        _dispatcher->publish(decoded.x, decoded.y, decoded.touched, ticks());
 
-        // pen down
-        if ((pen&AR1021_PEN_MASK) == (1<<7|1<<0)) {
-            actual.touched = true;
-        }
-        // pen up
-        else if ((pen&AR1021_PEN_MASK) == (1<<7)){
-            actual.touched = false;
-        }
-        // invalid value
-        else {
-            continue;
-        }
-        if(_rotated)
-        {
-          actual.y = ( ((xhi<<7)|xlo)* _height )>>12;
-          actual.x = ( ((yhi<<7)|ylo)* _width )>>12;
-        }
-        else
-        {
-          actual.x = ( ((xhi<<7)|xlo)* _width )>>12;
-          actual.y = ( ((yhi<<7)|ylo)* _height )>>12;
-        }
-    }
+    return true;
 }
 
 
@@ -21,6 +21,8 @@
 #include <stdbool.h>
 #include <avr/pgmspace.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -32,6 +34,14 @@
 #include "timer.h"
 #include "spiDevice.h"
 #include "ledHardware.h"
+#include "touchRecorder.h"
+#include "touchHex.h"
+#include "TouchPanel.h"
+#include "touchDispatcher.h"
+#include "touchCorrection.h"
+#include "touchDecoder.h"
+#include "touchSeqLock.h"
+#include "touchCoalescer.h"
 
 
 /******************************************************************************
@@ -79,11 +89,15 @@
 #define AR1021_ERR_INV_RESPLEN (-1003)
 #define AR1021_ERR_TIMEOUT     (-1004)
 
-// bit 7 is always 1 and bit 0 defines pen up or down
-#define AR1021_PEN_MASK (0x81)
-
 #define AR1021_NUM_CALIB_POINTS (4)
 
+// number of attempts to get a consistent snapshot in read()
+#define AR1021_SEQ_RETRIES (4)
+
+// bytes of a recording per line in dumpRecording()
+#define AR1021_DUMP_BYTES (24)
+
+
 
 /**
  * Microchip Touch Screen Controller (AR1021).
@@ -93,7 +107,7 @@
  * it is not needed to do additional calibrations since the stored
  * calibration data will be used.
  */
-class AR1021 : public spiDevice
+class AR1021 : public spiDevice, public StaticTouchPanel<AR1021>
 {
 public:
 
@@ -104,6 +118,21 @@ public:
         bool    touched;
     } touchCoordinate_t;
 
+    /**
+     * Extended touch sample. rawX/rawY are the unscaled 12-bit values of
+     * the controller (already swapped if the panel is rotated), x/y are the
+     * panel coordinates in fixed-point format with AR1021_SUBPIXEL_BITS
+     * fractional bits.
+     */
+    typedef struct
+    {
+        uint16_t rawX;
+        uint16_t rawY;
+        uint16_t x;
+        uint16_t y;
+        bool     touched;
+    } touchSample_t;
+
 
     /**
      * Constructor
@@ -136,6 +165,13 @@ public:
       actual.x = 0;
       actual.y = 0;
       actual.touched = false;
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+      actualSample.rawX = 0;
+      actualSample.rawY = 0;
+      actualSample.x = 0;
+      actualSample.y = 0;
+      actualSample.touched = false;
+#endif
       _initialized = false;
     }
 
@@ -144,24 +180,56 @@ public:
     void debug(const char *text);
     void debug(const char *text,int16_t zahl);
 
-    bool init(uint16_t width, uint16_t height, bool rotated );
+    bool init(uint16_t width, uint16_t height, bool rotated=false);
     bool read(touchCoordinate_t &coord);
+    bool read(TouchPanel::touchCoordinate_t &coord);
+    bool snapshot(touchCoordinate_t &coord, uint8_t *seq=NULL);
+    void setCoalescing(uint8_t minDistance, uint16_t minInterval, uint16_t maxLatency);
+    uint16_t suppressedEvents();
+    uint8_t sequence();
+    bool waitForChange(uint8_t *seq, uint32_t timeout);
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+    bool readSample(touchSample_t &sample);
+#endif
     bool calibrateStart();
     bool getNextCalibratePoint(uint16_t* x, uint16_t* y);
     bool waitForCalibratePoint(bool* morePoints, uint32_t timeout);
     void registerDump();
     void setRegister(uint8_t reg,uint8_t val,uint8_t offset);
 
-    void readTouchIrq(); // war private
+    void tick();
+    uint16_t ticks();
+    void setRecorder(TouchRecorder *recorder);
+    void setDispatcher(TouchDispatcher *dispatcher);
+    void setCorrection(TouchCorrection *correction);
+    void dumpRecording();
+
+    void readTouchIrq(); // war private, touch interrupt only
     void readTouch();
     bool compareCoord(const touchCoordinate_t& a, const touchCoordinate_t& b);
 
+    // actual is written by readTouchIrq() under the sequence counter,
+    // use read() or snapshot() to get a consistent copy
     touchCoordinate_t actual,lastActual;
 
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+    touchSample_t actualSample,lastSample;
+#endif
+
 private:
 
 
     Communication *_debugCom=NULL;
+    TouchRecorder *_recorder=NULL;
+    TouchDispatcher *_dispatcher=NULL;
+    TouchDecoder _decoder;
+    volatile uint16_t _ticks=0;
+    // odd while readTouchIrq() updates actual
+    TouchSeqLock<uint8_t> _seqLock;
+
+    // set by the first tick()
+    volatile bool _ticking=false;
+    TouchCoalescer _coalescer;
     volatile TIMER *_timeoutTimer;
     //DigitalOut _cs;
     //DigitalIn _siq;
@@ -176,6 +244,7 @@ private:
     int _calibPoint;
 
 
+    bool decodePacket(const uint8_t *packet);
     int cmd(char cmd, char* data, int len, char* respBuf, int* respLen, bool setCsOff=true);
     int waitForCalibResponse(uint32_t timeout);
 
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "hitGrid.h"
+
+
+void HitTracker::reset()
+{
+  _touched = false;
+  _region = HIT_NONE;
+}
+
+/**
+ * Feed the region found for a touch sample.
+ *
+ * @param region result of HitGrid::find() for the sample
+ * @param touched pen state of the sample
+ * @param events array of at least HIT_MAX_EVENTS entries
+ *
+ * @return number of events written to events
+ */
+uint8_t HitTracker::update(uint8_t region, bool touched, hitEvent_t *events)
+{
+  uint8_t n = 0;
+
+  // pen down
+  if (touched && !_touched) {
+    if (region != HIT_NONE) {
+      events[n].type = HIT_EVENT_ENTER;
+      events[n++].region = region;
+      events[n].type = HIT_EVENT_PRESS;
+      events[n++].region = region;
+    }
+  }
+  // pen up
+  else if (!touched && _touched) {
+    if (_region != HIT_NONE) {
+      events[n].type = HIT_EVENT_RELEASE;
+      events[n++].region = _region;
+      events[n].type = HIT_EVENT_LEAVE;
+      events[n++].region = _region;
+    }
+    region = HIT_NONE;
+  }
+  // move
+  else if (touched && region != _region) {
+    if (_region != HIT_NONE) {
+      events[n].type = HIT_EVENT_LEAVE;
+      events[n++].region = _region;
+    }
+    if (region != HIT_NONE) {
+      events[n].type = HIT_EVENT_ENTER;
+      events[n++].region = region;
+    }
+  }
+  else if (!touched) {
+    region = HIT_NONE;
+  }
+
+  _touched = touched;
+  _region = region;
+  return n;
+}
@@ -0,0 +1,369 @@
+/*
+ *  Hit testing of touch coordinates against rectangular screen regions.
+ *
+ *  The panel is divided into a uniform grid of COLS x ROWS cells. Every
+ *  cell keeps the ids of up to CELL_SLOTS regions overlapping it, so a
+ *  lookup only computes the cell and checks its few candidates, no
+ *  matter how many regions are on the screen.
+ *
+ *  A fixed layout can be indexed at compile time (C++11 constexpr):
+ *
+ *    static const hitRect_t rects[] = { ... };
+ *    static constexpr HitGrid<8, 6, 16, 4> grid(800, 480, rects);
+ *
+ *  A layout which does not fit into CELL_SLOTS fails to compile there.
+ */
+
+#ifndef HITGRID_H
+#define HITGRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#define HIT_NONE (0xFF)
+
+#define HIT_EVENT_ENTER   (0x01)
+#define HIT_EVENT_LEAVE   (0x02)
+#define HIT_EVENT_PRESS   (0x03)
+#define HIT_EVENT_RELEASE (0x04)
+
+// a sample creates at most 2 events (e.g. leave + enter)
+#define HIT_MAX_EVENTS (2)
+
+// rectangle in panel coordinates, x1 and y1 are exclusive
+typedef struct
+{
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} hitRect_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint8_t region;
+} hitEvent_t;
+
+// index sequences for the compile-time build, the list is built by
+// halving so the template depth stays logarithmic in the grid size
+template <uint16_t... I> struct hitIndices {};
+
+template <class A, class B> struct hitConcat;
+template <uint16_t... I, uint16_t... J>
+struct hitConcat<hitIndices<I...>, hitIndices<J...> >
+{
+    typedef hitIndices<I..., (uint16_t)(sizeof...(I)+J)...> type;
+};
+
+template <uint16_t N>
+struct hitMakeIndices
+{
+    typedef typename hitConcat<typename hitMakeIndices<N/2>::type,
+                               typename hitMakeIndices<N-N/2>::type>::type type;
+};
+template <> struct hitMakeIndices<0> { typedef hitIndices<> type; };
+template <> struct hitMakeIndices<1> { typedef hitIndices<0> type; };
+
+
+/**
+ * Grid index of up to MAX_REGIONS rectangular regions with ids
+ * 0..MAX_REGIONS-1. If regions overlap, the one added last wins.
+ */
+template <uint8_t COLS, uint8_t ROWS, uint8_t MAX_REGIONS, uint8_t CELL_SLOTS>
+class HitGrid
+{
+public:
+
+    /**
+     * @param width the width of the touch panel
+     * @param height the height of the touch panel. If width or height is
+     * 0 all coordinates fall into the first column or row.
+     */
+    HitGrid(uint16_t width, uint16_t height)
+    {
+      _scaleX = scale(COLS, width);
+      _scaleY = scale(ROWS, height);
+      clear();
+    }
+
+    /**
+     * Build the index of a static layout at compile time, the region ids
+     * are the indices in rects. If a cell runs out of slots the constant
+     * evaluation stops at cellSlotsExceeded(), a layout is never indexed
+     * in part. Only for constexpr objects, use build() at run time.
+     */
+    template <uint8_t N>
+    constexpr HitGrid(uint16_t width, uint16_t height, const hitRect_t (&rects)[N])
+      : HitGrid(scale(COLS, width), scale(ROWS, height), rects, N,
+                typename hitMakeIndices<MAX_REGIONS>::type(),
+                typename hitMakeIndices<COLS*ROWS>::type(),
+                typename hitMakeIndices<COLS*ROWS*CELL_SLOTS>::type())
+    {
+      static_assert(N <= MAX_REGIONS, "more rects than MAX_REGIONS");
+    }
+
+    void clear()
+    {
+      _complete = true;
+      for (uint8_t i = 0; i < MAX_REGIONS; i++) {
+        _rects[i].x0 = _rects[i].x1 = 0;
+        _rects[i].y0 = _rects[i].y1 = 0;
+      }
+      for (uint16_t c = 0; c < COLS*ROWS; c++)
+        _used[c] = 0;
+    }
+
+    /**
+     * Build the index for a static layout. The region ids are the
+     * indices in rects.
+     *
+     * @return false if a cell ran out of slots
+     */
+    bool build(const hitRect_t *rects, uint8_t count)
+    {
+      bool ok = true;
+      clear();
+      for (uint8_t i = 0; i < count && i < MAX_REGIONS; i++)
+        ok &= setRegion(i, rects[i]);
+      return ok;
+    }
+
+    /**
+     * Add a region or move an existing one.
+     *
+     * @return false if the id is invalid or a cell ran out of slots; the
+     * region is then removed
+     */
+    bool setRegion(uint8_t id, const hitRect_t &rect)
+    {
+      if (id >= MAX_REGIONS) return false;
+      removeRegion(id);
+      if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0) return true;
+      _rects[id] = rect;
+
+      uint8_t c0, c1, r0, r1;
+      cellRange(rect, c0, c1, r0, r1);
+      bool ok = true;
+      for (uint8_t r = r0; r <= r1; r++) {
+        for (uint8_t c = c0; c <= c1; c++) {
+          uint16_t cell = r*COLS + c;
+          if (_used[cell] < CELL_SLOTS)
+            _slots[cell*CELL_SLOTS + _used[cell]++] = id;
+          else
+            ok = false;
+        }
+      }
+      if (!ok) {
+        removeRegion(id);
+        _complete = false;
+      }
+      return ok;
+    }
+
+    void removeRegion(uint8_t id)
+    {
+      if (id >= MAX_REGIONS) return;
+      hitRect_t &rect = _rects[id];
+      if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0) return;
+
+      uint8_t c0, c1, r0, r1;
+      cellRange(rect, c0, c1, r0, r1);
+      for (uint8_t r = r0; r <= r1; r++) {
+        for (uint8_t c = c0; c <= c1; c++) {
+          uint16_t cell = r*COLS + c;
+          uint8_t n = 0;
+          uint8_t *slots = &_slots[cell*CELL_SLOTS];
+          for (uint8_t s = 0; s < _used[cell]; s++) {
+            if (slots[s] != id)
+              slots[n++] = slots[s];
+          }
+          _used[cell] = n;
+        }
+      }
+      rect.x0 = rect.x1 = 0;
+      rect.y0 = rect.y1 = 0;
+    }
+
+    /**
+     * @return id of the region at the coordinates or HIT_NONE
+     */
+    uint8_t find(int16_t x, int16_t y) const
+    {
+      if (x < 0 || y < 0) return HIT_NONE;
+      uint8_t c = column(x);
+      uint8_t r = row(y);
+      uint16_t cell = r*COLS + c;
+
+      for (uint8_t s = _used[cell]; s > 0; s--) {
+        uint8_t id = _slots[cell*CELL_SLOTS + s-1];
+        const hitRect_t &rect = _rects[id];
+        if (x >= rect.x0 && x < rect.x1 && y >= rect.y0 && y < rect.y1)
+          return id;
+      }
+      return HIT_NONE;
+    }
+
+    /**
+     * @return false if a region did not fit into the slots of a cell since
+     * the last clear() or build()
+     */
+    constexpr bool complete() const { return _complete; }
+
+private:
+
+    uint32_t  _scaleX;
+    uint32_t  _scaleY;
+    hitRect_t _rects[MAX_REGIONS];
+    uint8_t   _used[COLS*ROWS];
+    uint8_t   _slots[COLS*ROWS*CELL_SLOTS];
+    bool      _complete;
+
+    // fixed-point reciprocal, the cell of a coordinate is found with a
+    // multiplication instead of a division
+    static constexpr uint32_t scale(uint8_t cells, uint16_t size)
+    {
+      return size == 0 ? 0 : ((uint32_t)cells << 16) / size;
+    }
+
+    static constexpr uint8_t cellOf(int16_t v, uint32_t scale, uint8_t cells)
+    {
+      return (((uint32_t)v * scale) >> 16) >= cells ? cells-1 : ((uint32_t)v * scale) >> 16;
+    }
+
+    uint8_t column(int16_t x) const
+    {
+      return cellOf(x, _scaleX, COLS);
+    }
+
+    uint8_t row(int16_t y) const
+    {
+      return cellOf(y, _scaleY, ROWS);
+    }
+
+    // helpers of the compile-time build, C++11 constexpr functions are a
+    // single return statement; the recursions halve their range
+
+    template <uint16_t... R, uint16_t... C, uint16_t... S>
+    constexpr HitGrid(uint32_t scaleX, uint32_t scaleY, const hitRect_t *rects, uint8_t n,
+                      hitIndices<R...>, hitIndices<C...>, hitIndices<S...>)
+      : _scaleX(scaleX), _scaleY(scaleY),
+        _rects{ rectAt(rects, n, R)... },
+        _used{ usedAt(rects, n, scaleX, scaleY, C)... },
+        _slots{ slotAt(rects, n, scaleX, scaleY, S / CELL_SLOTS, S % CELL_SLOTS)... },
+        _complete(fits(rects, n, scaleX, scaleY, 0, COLS*ROWS) ? true : cellSlotsExceeded())
+    {
+    }
+
+    // neither constexpr nor defined: a layout which does not fit into the
+    // slots is a compile error, not a partly indexed grid
+    static bool cellSlotsExceeded();
+
+    static constexpr hitRect_t rectAt(const hitRect_t *rects, uint8_t n, uint8_t id)
+    {
+      return (id < n && rects[id].x1 > rects[id].x0 && rects[id].y1 > rects[id].y0)
+             ? rects[id] : hitRect_t{ 0, 0, 0, 0 };
+    }
+
+    static constexpr int16_t clampLow(int16_t v)
+    {
+      return v < 0 ? 0 : v;
+    }
+
+    static constexpr bool covers(const hitRect_t &rect, uint32_t scaleX, uint32_t scaleY,
+                                 uint16_t cell)
+    {
+      return rect.x1 > rect.x0 && rect.y1 > rect.y0
+          && cellOf(clampLow(rect.x0), scaleX, COLS) <= cell % COLS
+          && cell % COLS <= cellOf(clampLow(rect.x1-1), scaleX, COLS)
+          && cellOf(clampLow(rect.y0), scaleY, ROWS) <= cell / COLS
+          && cell / COLS <= cellOf(clampLow(rect.y1-1), scaleY, ROWS);
+    }
+
+    // number of regions lo..hi-1 covering the cell
+    static constexpr uint8_t countIn(const hitRect_t *rects, uint32_t scaleX, uint32_t scaleY,
+                                     uint16_t cell, uint8_t lo, uint8_t hi)
+    {
+      return hi - lo == 0 ? 0
+           : hi - lo == 1 ? (covers(rects[lo], scaleX, scaleY, cell) ? 1 : 0)
+           : countIn(rects, scaleX, scaleY, cell, lo, lo + (hi-lo)/2)
+             + countIn(rects, scaleX, scaleY, cell, lo + (hi-lo)/2, hi);
+    }
+
+    // id of the k-th region of lo..hi-1 covering the cell
+    static constexpr uint8_t nthIn(const hitRect_t *rects, uint32_t scaleX, uint32_t scaleY,
+                                   uint16_t cell, uint8_t k, uint8_t lo, uint8_t hi)
+    {
+      return hi - lo == 1 ? lo
+           : k < countIn(rects, scaleX, scaleY, cell, lo, lo + (hi-lo)/2)
+             ? nthIn(rects, scaleX, scaleY, cell, k, lo, lo + (hi-lo)/2)
+             : nthIn(rects, scaleX, scaleY, cell,
+                     k - countIn(rects, scaleX, scaleY, cell, lo, lo + (hi-lo)/2),
+                     lo + (hi-lo)/2, hi);
+    }
+
+    static constexpr uint8_t usedAt(const hitRect_t *rects, uint8_t n, uint32_t scaleX,
+                                    uint32_t scaleY, uint16_t cell)
+    {
+      return countIn(rects, scaleX, scaleY, cell, 0, n) > CELL_SLOTS
+             ? CELL_SLOTS : countIn(rects, scaleX, scaleY, cell, 0, n);
+    }
+
+    static constexpr uint8_t slotAt(const hitRect_t *rects, uint8_t n, uint32_t scaleX,
+                                    uint32_t scaleY, uint16_t cell, uint8_t slot)
+    {
+      return slot < usedAt(rects, n, scaleX, scaleY, cell)
+             ? nthIn(rects, scaleX, scaleY, cell, slot, 0, n) : 0;
+    }
+
+    // true if no cell of lo..hi-1 is covered by more than CELL_SLOTS regions
+    static constexpr bool fits(const hitRect_t *rects, uint8_t n, uint32_t scaleX,
+                               uint32_t scaleY, uint16_t lo, uint16_t hi)
+    {
+      return hi - lo == 1 ? countIn(rects, scaleX, scaleY, lo, 0, n) <= CELL_SLOTS
+           : fits(rects, n, scaleX, scaleY, lo, lo + (hi-lo)/2)
+             && fits(rects, n, scaleX, scaleY, lo + (hi-lo)/2, hi);
+    }
+
+    void cellRange(const hitRect_t &rect, uint8_t &c0, uint8_t &c1, uint8_t &r0, uint8_t &r1) const
+    {
+      c0 = column(rect.x0 < 0 ? 0 : rect.x0);
+      c1 = column(rect.x1-1 < 0 ? 0 : rect.x1-1);
+      r0 = row(rect.y0 < 0 ? 0 : rect.y0);
+      r1 = row(rect.y1-1 < 0 ? 0 : rect.y1-1);
+    }
+};
+
+
+/**
+ * Turns the region under the pen into region events. While the pen is
+ * down, moving from one region to another gives LEAVE and ENTER. Pen down
+ * gives ENTER and PRESS, pen up gives RELEASE and LEAVE.
+ */
+class HitTracker
+{
+public:
+
+    HitTracker()
+    {
+      reset();
+    }
+
+    void reset();
+    uint8_t update(uint8_t region, bool touched, hitEvent_t *events);
+
+    uint8_t current() const { return _region; }
+
+private:
+
+    bool    _touched;
+    uint8_t _region;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ *  Throughput and latency of the AR1021 driver per touch packet, on the
+ *  simulated SPI bus: the packet is queued, which raises SIQ,
+ *  readTouchIrq() clocks it in and read() returns the coordinate. The
+ *  cost of the simulated bus is included.
+ *
+ *  usage: bench_ar1021 [trace.txt ...]
+ *
+ *  Without arguments the generated traces are used, otherwise the given
+ *  recorded traces.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "ar1021.h"
+#include "hostAr1021.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (50)
+
+static volatile TIMER timeout;
+
+static void bench(const char *name, const trace_t &trace, bool coalesce)
+{
+    std::vector<uint8_t> packets(trace.size() * AR1021_PACKET_SIZE);
+    for (size_t i = 0; i < trace.size(); i++)
+        traceToPacket(trace[i], TRACE_WIDTH, TRACE_HEIGHT, &packets[i*AR1021_PACKET_SIZE]);
+
+    hostAr1021.reset();
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    driver.init(TRACE_WIDTH, TRACE_HEIGHT, false);
+    if (coalesce) driver.setCoalescing(2, 10, 50);
+
+    AR1021::touchCoordinate_t coord;
+    std::vector<uint64_t> latency(trace.size());
+    uint64_t best = ~0ULL;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            hostAr1021.queue(&packets[i*AR1021_PACKET_SIZE], AR1021_PACKET_SIZE);
+            driver.readTouchIrq();
+            driver.tick();
+            benchKeep(driver.read(coord));
+        }
+        uint64_t elapsed = benchNow() - start;
+        if (elapsed < best) best = elapsed;
+    }
+
+    // from SIQ to the coordinate in read(), packet by packet
+    for (size_t i = 0; i < trace.size(); i++) {
+        uint64_t start = benchNow();
+        hostAr1021.queue(&packets[i*AR1021_PACKET_SIZE], AR1021_PACKET_SIZE);
+        driver.readTouchIrq();
+        driver.tick();
+        benchKeep(driver.read(coord));
+        latency[i] = benchNow() - start;
+    }
+    std::sort(latency.begin(), latency.end());
+
+    printf("%-12s %-10s %6u packets  %6.1f %s/packet, latency median %4u, 99%% %4u\n",
+           name, coalesce ? "coalesced" : "plain", (unsigned)trace.size(),
+           (double)best / trace.size(), BENCH_UNIT,
+           (unsigned)latency[latency.size()/2], (unsigned)latency[latency.size()*99/100]);
+}
+
+static void benchBoth(const char *name, const trace_t &trace)
+{
+    bench(name, trace, false);
+    bench(name, trace, true);
+}
+
+int main(int argc, char **argv)
+{
+    hostAr1021.attachTimer(&timeout);
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            trace_t trace = traceLoad(argv[i]);
+            if (trace.empty()) {
+                printf("%s: no samples\n", argv[i]);
+                return 1;
+            }
+            benchBoth(argv[i], trace);
+        }
+        return 0;
+    }
+
+    benchBoth("signature", traceSignature(12));
+    benchBoth("scribble", traceScribble(8));
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ *  Cost of HitGrid::find() compared to a linear scan of the regions, for
+ *  layouts with an increasing number of buttons.
+ *
+ *  usage: bench_hitGrid [trace.txt ...]
+ *
+ *  The lookups are the samples of the generated traces, or of the given
+ *  recorded traces.
+ */
+
+#include <stdio.h>
+#include <vector>
+
+#include "hitGrid.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (200)
+
+typedef HitGrid<16, 12, 64, 4> grid_t;
+
+// reverse scan, the region added last wins as in HitGrid
+static uint8_t findLinear(const hitRect_t *rects, uint8_t count, int16_t x, int16_t y)
+{
+    for (uint8_t id = count; id > 0; id--) {
+        const hitRect_t &r = rects[id-1];
+        if (x >= r.x0 && x < r.x1 && y >= r.y0 && y < r.y1)
+            return id-1;
+    }
+    return HIT_NONE;
+}
+
+// cols x rows buttons with a gap, covering the panel
+static std::vector<hitRect_t> buttons(int cols, int rows)
+{
+    std::vector<hitRect_t> rects;
+    int w = TRACE_WIDTH / cols, h = TRACE_HEIGHT / rows;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            hitRect_t rect = { (int16_t)(c*w + 4), (int16_t)(r*h + 4),
+                               (int16_t)(c*w + w - 4), (int16_t)(r*h + h - 4) };
+            rects.push_back(rect);
+        }
+    }
+    return rects;
+}
+
+static void bench(const char *name, const trace_t &trace, int cols, int rows)
+{
+    std::vector<hitRect_t> rects = buttons(cols, rows);
+    uint8_t count = rects.size();
+    grid_t grid(TRACE_WIDTH, TRACE_HEIGHT);
+    if (!grid.build(&rects[0], count)) {
+        printf("%s: layout does not fit\n", name);
+        return;
+    }
+
+    uint64_t bestGrid = ~0ULL, bestLinear = ~0ULL;
+    uint32_t hits = 0, mismatches = 0;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            uint8_t id = grid.find(trace[i].x, trace[i].y);
+            benchKeep(id);
+        }
+        uint64_t elapsed = benchNow() - start;
+        if (elapsed < bestGrid) bestGrid = elapsed;
+
+        start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            uint8_t id = findLinear(&rects[0], count, trace[i].x, trace[i].y);
+            benchKeep(id);
+        }
+        elapsed = benchNow() - start;
+        if (elapsed < bestLinear) bestLinear = elapsed;
+    }
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        uint8_t id = grid.find(trace[i].x, trace[i].y);
+        hits += id != HIT_NONE;
+        mismatches += id != findLinear(&rects[0], count, trace[i].x, trace[i].y);
+    }
+    if (mismatches)
+        printf("%s: %u lookups differ\n", name, mismatches);
+
+    printf("%-12s %3u regions %6u lookups %5u hits  grid %5.1f  linear %5.1f %s/lookup\n",
+           name, count, (unsigned)trace.size(), hits,
+           (double)bestGrid / trace.size(), (double)bestLinear / trace.size(), BENCH_UNIT);
+}
+
+int main(int argc, char **argv)
+{
+    static const int layouts[][2] = { { 2, 2 }, { 4, 3 }, { 8, 4 }, { 8, 8 } };
+
+    for (size_t l = 0; l < sizeof(layouts)/sizeof(layouts[0]); l++) {
+        int cols = layouts[l][0], rows = layouts[l][1];
+        if (argc > 1) {
+            for (int i = 1; i < argc; i++) {
+                trace_t trace = traceLoad(argv[i]);
+                if (trace.empty()) {
+                    printf("%s: no samples\n", argv[i]);
+                    return 1;
+                }
+                bench(argv[i], trace, cols, rows);
+            }
+        }
+        else {
+            bench("scribble", traceScribble(8), cols, rows);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ *  Compression ratio and cost per point of InkCapture.
+ *
+ *  usage: bench_inkCapture [trace.txt ...]
+ *
+ *  Without arguments the generated traces are used, otherwise the given
+ *  recorded traces. The ratio compares the stream with the 5-byte AR1021
+ *  packets of the input.
+ */
+
+#include <stdio.h>
+
+#include "inkCapture.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (200)
+
+static void bench(const char *name, const trace_t &trace)
+{
+    InkCapture ink;
+    uint8_t buf[255];
+    uint32_t bytes = 0;
+    uint64_t best = ~0ULL;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        ink.reset();
+        bytes = 0;
+        uint64_t start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            ink.addSample(trace[i].x, trace[i].y, trace[i].touched);
+            bytes += ink.readBytes(buf, sizeof(buf));
+        }
+        uint64_t elapsed = benchNow() - start;
+        benchKeep(buf);
+        if (elapsed < best) best = elapsed;
+    }
+
+    uint32_t raw = trace.size() * 5;
+    printf("%-12s %6u samples %5u points %6u bytes  ratio %5.1f:1  %6.1f %s/sample\n",
+           name, (unsigned)trace.size(), ink.pointsOut, bytes,
+           bytes ? (double)raw / bytes : 0.0, (double)best / trace.size(), BENCH_UNIT);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            trace_t trace = traceLoad(argv[i]);
+            if (trace.empty()) {
+                printf("%s: no samples\n", argv[i]);
+                return 1;
+            }
+            bench(argv[i], trace);
+        }
+        return 0;
+    }
+
+    bench("semicircle", traceSemicircle(100, 2000));
+    bench("signature", traceSignature(12));
+    bench("scribble", traceScribble(8));
+    bench("resting", traceResting(400, 100, 2));
+    return 0;
+}
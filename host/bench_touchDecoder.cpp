@@ -0,0 +1,78 @@
+/*
+ *  Cost per packet of TouchDecoder, as run by the driver for every touch
+ *  packet, without and with the mesh correction.
+ *
+ *  usage: bench_touchDecoder [trace.txt ...]
+ *
+ *  Without arguments the generated traces are used, otherwise the given
+ *  recorded traces.
+ */
+
+#include <stdio.h>
+#include <vector>
+
+#include "touchDecoder.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (200)
+
+static void bench(const char *name, const trace_t &trace, TouchCorrection *corr)
+{
+    std::vector<uint8_t> packets(trace.size() * AR1021_PACKET_SIZE);
+    for (size_t i = 0; i < trace.size(); i++)
+        traceToPacket(trace[i], TRACE_WIDTH, TRACE_HEIGHT, &packets[i*AR1021_PACKET_SIZE]);
+
+    TouchDecoder dec;
+    touchDecoded_t out;
+    uint64_t best = ~0ULL;
+
+    dec.init(TRACE_WIDTH, TRACE_HEIGHT, false);
+    dec.setCorrection(corr);
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            dec.decode(&packets[i*AR1021_PACKET_SIZE], out);
+            benchKeep(out);
+        }
+        uint64_t elapsed = benchNow() - start;
+        if (elapsed < best) best = elapsed;
+    }
+
+    printf("%-12s %-10s %6u packets  %6.1f %s/packet\n",
+           name, corr ? "corrected" : "plain", (unsigned)trace.size(),
+           (double)best / trace.size(), BENCH_UNIT);
+}
+
+static void benchBoth(const char *name, const trace_t &trace)
+{
+    // a mesh with varying offsets, so every cell is interpolated
+    TouchCorrection corr;
+    int8_t data[TOUCH_MESH_DATA_SIZE];
+    for (int i = 0; i < TOUCH_MESH_DATA_SIZE; i++)
+        data[i] = (int8_t)((i * 37) % 41 - 20);
+    corr.init(TRACE_WIDTH, TRACE_HEIGHT);
+    corr.setData(data);
+
+    bench(name, trace, NULL);
+    bench(name, trace, &corr);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            trace_t trace = traceLoad(argv[i]);
+            if (trace.empty()) {
+                printf("%s: no samples\n", argv[i]);
+                return 1;
+            }
+            benchBoth(argv[i], trace);
+        }
+        return 0;
+    }
+
+    benchBoth("signature", traceSignature(12));
+    benchBoth("scribble", traceScribble(8));
+    return 0;
+}
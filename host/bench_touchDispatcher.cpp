@@ -0,0 +1,80 @@
+/*
+ *  Cost of TouchDispatcher::publish() per event for 1 to
+ *  TOUCH_DISPATCH_MAX_SUBSCRIBERS subscribers, called directly (ISR mode)
+ *  or queued and delivered by process() (deferred mode). The deferred
+ *  cost includes process().
+ *
+ *  usage: bench_touchDispatcher [trace.txt ...]
+ *
+ *  Without arguments the generated traces are used, otherwise the given
+ *  recorded traces.
+ */
+
+#include <stdio.h>
+
+#include "touchDispatcher.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (200)
+
+static void onEvent(const dispatchEvent_t &event, void *ctx)
+{
+    *(int32_t*)ctx += event.x + event.y;
+}
+
+static void bench(const char *name, const trace_t &trace, uint8_t subscribers, uint8_t mode)
+{
+    int32_t sums[TOUCH_DISPATCH_MAX_SUBSCRIBERS] = {};
+    uint64_t best = ~0ULL;
+    uint16_t overflows = 0;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        TouchDispatcher disp;
+        for (uint8_t i = 0; i < subscribers; i++)
+            disp.subscribe(onEvent, &sums[i], i, TOUCH_EVT_ALL, 1, mode);
+
+        // the main loop catches up whenever the queue is nearly full
+        uint64_t start = benchNow();
+        for (size_t i = 0; i < trace.size(); i++) {
+            disp.publish(trace[i].x, trace[i].y, trace[i].touched, trace[i].t);
+            if (i % (TOUCH_DISPATCH_QUEUE_SIZE-1) == TOUCH_DISPATCH_QUEUE_SIZE-2)
+                disp.process();
+        }
+        disp.process();
+        uint64_t elapsed = benchNow() - start;
+        if (elapsed < best) best = elapsed;
+        overflows = disp.queueOverflows;
+    }
+    benchKeep(sums);
+
+    printf("%-12s %u %-8s %6u events %3u overflows  %6.1f %s/event\n",
+           name, subscribers, mode == TOUCH_DISPATCH_ISR ? "isr" : "deferred",
+           (unsigned)trace.size(), overflows, (double)best / trace.size(), BENCH_UNIT);
+}
+
+static void benchAll(const char *name, const trace_t &trace)
+{
+    for (uint8_t n = 1; n <= TOUCH_DISPATCH_MAX_SUBSCRIBERS; n++) {
+        bench(name, trace, n, TOUCH_DISPATCH_ISR);
+        bench(name, trace, n, TOUCH_DISPATCH_DEFERRED);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            trace_t trace = traceLoad(argv[i]);
+            if (trace.empty()) {
+                printf("%s: no samples\n", argv[i]);
+                return 1;
+            }
+            benchAll(argv[i], trace);
+        }
+        return 0;
+    }
+
+    benchAll("scribble", traceScribble(8));
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ *  Cost of a read() through StaticTouchPanel compared to the virtual
+ *  TouchPanel interface (TouchPanelAdapter), with the mock panel.
+ *
+ *  The virtual calls go through a pointer the compiler cannot see
+ *  through, as in firmware where the panel is chosen at runtime.
+ */
+
+#include <stdio.h>
+
+#include "mockTouchPanel.h"
+#include "hostBench.h"
+#include "hostTraces.h"
+
+#define BENCH_ROUNDS (200)
+
+template <class Panel>
+static int32_t drainStatic(StaticTouchPanel<Panel> &tp)
+{
+    TouchPanel::touchCoordinate_t coord;
+    int32_t sum = 0;
+    while (tp.panel().read(coord))
+        sum += coord.x + coord.y + coord.z;
+    return sum;
+}
+
+static __attribute__((noinline)) int32_t drainVirtual(TouchPanel *tp)
+{
+    TouchPanel::touchCoordinate_t coord;
+    int32_t sum = 0;
+    while (tp->read(coord))
+        sum += coord.x + coord.y + coord.z;
+    return sum;
+}
+
+int main()
+{
+    trace_t trace = traceScribble(8);
+    MockTouchPanel mock(trace);
+    TouchPanelAdapter<MockTouchPanel> adapter(mock);
+    TouchPanel *tp = &adapter;
+    uint64_t bestStatic = ~0ULL, bestVirtual = ~0ULL;
+    int32_t sumStatic = 0, sumVirtual = 0;
+
+    // hide the dynamic type from the compiler
+    __asm__ __volatile__ ("" : "+r"(tp));
+
+    if (!mock.panel().init(TRACE_WIDTH, TRACE_HEIGHT)) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        mock.rewind();
+        uint64_t start = benchNow();
+        sumStatic = drainStatic(mock);
+        uint64_t elapsed = benchNow() - start;
+        if (elapsed < bestStatic) bestStatic = elapsed;
+
+        mock.rewind();
+        start = benchNow();
+        sumVirtual = drainVirtual(tp);
+        elapsed = benchNow() - start;
+        if (elapsed < bestVirtual) bestVirtual = elapsed;
+    }
+    benchKeep(sumStatic);
+    benchKeep(sumVirtual);
+
+    if (sumStatic != sumVirtual) {
+        printf("static and virtual reads differ\n");
+        return 1;
+    }
+    printf("static       %6u reads  %6.1f %s/read\n", (unsigned)trace.size(),
+           (double)bestStatic / trace.size(), BENCH_UNIT);
+    printf("virtual      %6u reads  %6.1f %s/read\n", (unsigned)trace.size(),
+           (double)bestVirtual / trace.size(), BENCH_UNIT);
+    return 0;
+}
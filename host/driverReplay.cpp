@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "driverReplay.h"
+#include "hostAr1021.h"
+
+
+DriverReplay::DriverReplay(AR1021 &driver, const uint8_t *data, uint16_t len)
+  : _driver(driver), _replay(data, len, NULL, NULL)
+{
+  touchRecord_t record;
+
+  packets = 0;
+  commandsReplayed = commandsMissing = commandsMismatched = 0;
+  _nextCommand = 0;
+  _answer = true;
+
+  while (_replay.next(record)) {
+    if (record.type == TOUCH_REC_CMD && record.len >= 3)
+      _commands.push_back(record);
+  }
+  _replay.rewind();
+
+  hostAr1021.reset();
+  hostAr1021.setCommandHandler(onCommand, this);
+}
+
+DriverReplay::~DriverReplay()
+{
+  hostAr1021.setCommandHandler(NULL, NULL);
+}
+
+bool DriverReplay::recordedInit() const
+{
+  return !_commands.empty() && _commands[0].payload[0] == AR1021_CMD_DISABLE_TOUCH;
+}
+
+/**
+ * Deliver the next recorded touch packet to the driver.
+ *
+ * @param timestamp the recorded time of the packet
+ *
+ * @return false at the end of the recording
+ */
+bool DriverReplay::next(uint16_t &timestamp)
+{
+  touchRecord_t record;
+
+  while (_replay.next(record)) {
+    if (record.type != TOUCH_REC_PACKET || record.len != AR1021_PACKET_SIZE)
+      continue;
+
+    while (_driver.ticks() != record.timestamp)
+      _driver.tick();
+
+    hostAr1021.flush();
+    hostAr1021.queue(record.payload, record.len);
+    _driver.readTouchIrq();
+
+    packets++;
+    timestamp = record.timestamp;
+    return true;
+  }
+  return false;
+}
+
+void DriverReplay::onCommand(uint8_t cmd, const uint8_t *, uint8_t, void *ctx)
+{
+  ((DriverReplay*)ctx)->answer(cmd);
+}
+
+// rebuild the response which made cmd() return the recorded result
+void DriverReplay::answer(uint8_t cmd)
+{
+  hostAr1021.flush();
+
+  if (!_answer || _nextCommand >= _commands.size()) {
+    if (_answer) commandsMissing++;
+    hostAr1021.respond(cmd, AR1021_RESP_STAT_OK, NULL, 0);
+    return;
+  }
+
+  const touchRecord_t &record = _commands[_nextCommand++];
+  const uint8_t *p = record.payload;
+  int16_t result = p[1] | ((uint16_t)p[2] << 8);
+
+  commandsReplayed++;
+  if (p[0] != cmd) commandsMismatched++;
+
+  if (result == 0) {
+    hostAr1021.respond(cmd, AR1021_RESP_STAT_OK, &p[3], record.len - 3);
+  }
+  else if (result < 0 && result > -256) {
+    hostAr1021.respond(cmd, -result, NULL, 0);
+  }
+  else if (result == AR1021_ERR_NO_HDR) {
+    const uint8_t noHeader[1] = { 0 };
+    hostAr1021.queue(noHeader, sizeof(noHeader));
+  }
+  else if (result == AR1021_ERR_INV_LEN) {
+    const uint8_t shortFrame[2] = { 0x55, 1 };
+    hostAr1021.queue(shortFrame, sizeof(shortFrame));
+  }
+  else if (result == AR1021_ERR_INV_RESP) {
+    hostAr1021.respond(cmd + 1, AR1021_RESP_STAT_OK, NULL, 0);
+  }
+  else if (result == AR1021_ERR_INV_RESPLEN) {
+    hostAr1021.respond(cmd, AR1021_RESP_STAT_OK, NULL, TOUCH_REC_MAX_RESP);
+  }
+  // AR1021_ERR_TIMEOUT: no response, SIQ stays low
+}
@@ -0,0 +1,52 @@
+/*
+ *  Replay of a TouchRecorder recording through the AR1021 driver.
+ *
+ *  The recorded command results answer the commands the driver sends, in
+ *  the recorded order. The recorded touch packets are clocked into the
+ *  driver over the simulated SPI bus (stub/hostAr1021.h): the driver
+ *  ticks are advanced to the timestamp of the packet, the packet is
+ *  queued, which raises SIQ, and readTouchIrq() runs as the interrupt
+ *  would. Everything behind it (sequence counter, read(), coalescing,
+ *  correction, dispatcher) runs unchanged.
+ */
+
+#ifndef DRIVERREPLAY_H
+#define DRIVERREPLAY_H
+
+#include <vector>
+
+#include "ar1021.h"
+
+class DriverReplay
+{
+public:
+
+    DriverReplay(AR1021 &driver, const uint8_t *data, uint16_t len);
+    ~DriverReplay();
+
+    // true if the recording starts with the command sequence of init()
+    bool recordedInit() const;
+
+    // answer commands from the recording, or with OK if disabled
+    void setAnswerFromRecording(bool enable) { _answer = enable; }
+
+    bool next(uint16_t &timestamp);
+
+    uint16_t packets;
+    uint16_t commandsReplayed;
+    uint16_t commandsMissing;       // answered with OK, none recorded
+    uint16_t commandsMismatched;    // answered with a record of another command
+
+private:
+
+    AR1021     &_driver;
+    TouchReplay _replay;
+    std::vector<touchRecord_t> _commands;
+    size_t      _nextCommand;
+    bool        _answer;
+
+    static void onCommand(uint8_t cmd, const uint8_t *data, uint8_t len, void *ctx);
+    void answer(uint8_t cmd);
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ *  Decode and replay touch frames captured from the host link.
+ *
+ *  usage: frameReplay [-b] [-r speed] [file]
+ *
+ *  Reads the hex encoded frames sent by TouchTelemetry over
+ *  Communication::sendInfo() (any other text on a line is skipped), or
+ *  raw binary frames with -b, from file or stdin. Every event is printed
+ *  as "t x y touched", the format read by the benchmarks. With -r the
+ *  events are printed at their original pace divided by speed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "touchFrame.h"
+#include "touchHex.h"
+
+typedef struct
+{
+    double   speed;
+    bool     started;
+    uint16_t last;
+} replay_t;
+
+static void onEvent(const touchEvent_t &event, void *ctx)
+{
+    replay_t *r = (replay_t*)ctx;
+
+    if (r->speed > 0 && r->started) {
+        uint16_t dt = event.timestamp - r->last;
+        fflush(stdout);
+        usleep((useconds_t)(dt * 1000.0 / r->speed));
+    }
+    r->started = true;
+    r->last = event.timestamp;
+    printf("%u %d %d %d\n", event.timestamp, event.x, event.y, event.touched ? 1 : 0);
+}
+
+static bool isHex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+}
+
+int main(int argc, char **argv)
+{
+    replay_t replay = { 0, false, 0 };
+    bool binary = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "br:")) != -1) {
+        switch (opt) {
+        case 'b':
+            binary = true;
+            break;
+        case 'r':
+            replay.speed = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-b] [-r speed] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *in = stdin;
+    if (optind < argc) {
+        in = fopen(argv[optind], binary ? "rb" : "r");
+        if (in == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    TouchFrameDecoder dec(onEvent, &replay);
+
+    if (binary) {
+        uint8_t buf[256];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+            dec.feed(buf, n);
+    }
+    else {
+        char line[1024];
+        uint8_t buf[sizeof(line)/2];
+        while (fgets(line, sizeof(line), in) != NULL) {
+            // decode every run of hex digits, the decoder finds the frames
+            for (char *p = line; *p; ) {
+                if (!isHex(*p)) {
+                    p++;
+                    continue;
+                }
+                size_t run = 0;
+                while (isHex(p[run])) run++;
+                uint16_t n = touchHexDecode(p + (run & 1), buf, run/2);
+                dec.feed(buf, n);
+                p += run;
+            }
+        }
+    }
+
+    if (in != stdin) fclose(in);
+    fprintf(stderr, "frames ok %u, bad %u, lost %u\n", dec.framesOk, dec.framesBad, dec.framesLost);
+    return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ *  Timing for the host benchmarks. On x86 the time stamp counter is used
+ *  and results are in cycles, elsewhere in nanoseconds.
+ */
+
+#ifndef HOSTBENCH_H
+#define HOSTBENCH_H
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t benchNow()
+{
+    return __rdtsc();
+}
+#else
+#include <chrono>
+#define BENCH_UNIT "ns"
+static inline uint64_t benchNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+// keeps the compiler from optimizing away a benchmarked result
+template <class T>
+static inline void benchKeep(const T &value)
+{
+    __asm__ __volatile__ ("" : : "g"(&value) : "memory");
+}
+
+#endif
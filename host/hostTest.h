@@ -0,0 +1,37 @@
+/*
+ *  Minimal checks for the host tests. A test program returns the number
+ *  of failed checks, so make check stops at the first failing program.
+ */
+
+#ifndef HOSTTEST_H
+#define HOSTTEST_H
+
+#include <stdio.h>
+
+static int hostFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            hostFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        long long va = (long long)(a), vb = (long long)(b); \
+        if (va != vb) { \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                   __FILE__, __LINE__, #a, #b, va, vb); \
+            hostFailures++; \
+        } \
+    } while (0)
+
+static inline int hostResult(const char *name)
+{
+    printf("%s: %s\n", name, hostFailures ? "FAILED" : "ok");
+    return hostFailures;
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ *  Touch traces for the host tests and benchmarks.
+ *
+ *  The generated traces model the reports of an AR1021 on an 800x480
+ *  panel: ~5 ms report interval, quantized coordinates and +-jitter from
+ *  a fixed-seed generator, so every run sees the same samples. Recorded
+ *  traces are loaded with traceLoad() from the "t x y touched" text
+ *  written by the touchReplay tool.
+ */
+
+#ifndef HOSTTRACES_H
+#define HOSTTRACES_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#define TRACE_WIDTH    (800)
+#define TRACE_HEIGHT   (480)
+#define TRACE_INTERVAL (5)
+
+typedef struct
+{
+    uint16_t t;
+    int16_t  x;
+    int16_t  y;
+    bool     touched;
+} traceSample_t;
+
+typedef std::vector<traceSample_t> trace_t;
+
+// fixed-seed generator, independent of the C library
+static inline int traceRand(uint32_t &state, int range)
+{
+    state = state*1103515245u + 12345u;
+    return (int)((state >> 16) % (uint32_t)(2*range+1)) - range;
+}
+
+static inline void tracePush(trace_t &trace, double x, double y, bool touched)
+{
+    traceSample_t s;
+    s.t = trace.empty() ? 0 : trace.back().t + TRACE_INTERVAL;
+    s.x = (int16_t)lround(x);
+    s.y = (int16_t)lround(y);
+    s.touched = touched;
+    trace.push_back(s);
+}
+
+static inline void tracePenUp(trace_t &trace)
+{
+    traceSample_t s = trace.back();
+    s.t += TRACE_INTERVAL;
+    s.touched = false;
+    trace.push_back(s);
+}
+
+// finely sampled semicircle, no jitter
+static inline trace_t traceSemicircle(double r, int steps)
+{
+    trace_t trace;
+    for (int i = 0; i <= steps; i++) {
+        double a = M_PI * i / steps;
+        tracePush(trace, 400 + r*cos(a), 300 - r*sin(a), true);
+    }
+    tracePenUp(trace);
+    return trace;
+}
+
+// handwriting-like strokes: loops and curves with +-1 pixel jitter
+static inline trace_t traceSignature(int strokes)
+{
+    trace_t trace;
+    uint32_t seed = 1;
+    for (int s = 0; s < strokes; s++) {
+        double x0 = 80 + (s % 6) * 110, y0 = 120 + (s / 6) * 150;
+        for (int i = 0; i < 120; i++) {
+            double a = i * 0.08;
+            tracePush(trace, x0 + 3*i*0.25 + 30*sin(a*1.7) + traceRand(seed, 1),
+                             y0 + 40*sin(a) + 15*cos(a*2.3) + traceRand(seed, 1), true);
+        }
+        tracePenUp(trace);
+    }
+    return trace;
+}
+
+// strokes going back and forth over the same line
+static inline trace_t traceScribble(int strokes)
+{
+    trace_t trace;
+    for (int s = 0; s < strokes; s++) {
+        double y = 100 + s*20;
+        for (int i = 0; i < 200; i++) {
+            int phase = i % 40;
+            double x = 100 + (phase < 20 ? phase : 40 - phase) * 10;
+            tracePush(trace, x, y, true);
+        }
+        tracePenUp(trace);
+    }
+    return trace;
+}
+
+// a finger resting on the panel with +-jitter, then dragged, then lifted
+static inline trace_t traceResting(int restSamples, int dragSamples, int jitter)
+{
+    trace_t trace;
+    uint32_t seed = 7;
+    for (int i = 0; i < restSamples; i++)
+        tracePush(trace, 400 + traceRand(seed, jitter), 240 + traceRand(seed, jitter), true);
+    for (int i = 0; i < dragSamples; i++)
+        tracePush(trace, 400 + i*2 + traceRand(seed, jitter), 240 + traceRand(seed, jitter), true);
+    tracePenUp(trace);
+    return trace;
+}
+
+// AR1021 packet of a trace sample, the inverse of the 12-bit scaling
+static inline void traceToPacket(const traceSample_t &s, uint16_t width, uint16_t height,
+                                 uint8_t packet[5])
+{
+    uint16_t rawX = (uint16_t)(((uint32_t)s.x*4096 + width-1) / width);
+    uint16_t rawY = (uint16_t)(((uint32_t)s.y*4096 + height-1) / height);
+    packet[0] = s.touched ? 0x81 : 0x80;
+    packet[1] = rawX & 0x7F;
+    packet[2] = rawX >> 7;
+    packet[3] = rawY & 0x7F;
+    packet[4] = rawY >> 7;
+}
+
+// load "t x y touched" lines, returns an empty trace on error
+static inline trace_t traceLoad(const char *path)
+{
+    trace_t trace;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return trace;
+    unsigned t;
+    int x, y, touched;
+    while (fscanf(f, "%u %d %d %d", &t, &x, &y, &touched) == 4) {
+        traceSample_t s;
+        s.t = t;
+        s.x = x;
+        s.y = y;
+        s.touched = touched != 0;
+        trace.push_back(s);
+    }
+    fclose(f);
+    return trace;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ *  Touch panel for the host, plays back a trace through the
+ *  StaticTouchPanel interface. Every read() returns the next sample.
+ */
+
+#ifndef MOCKTOUCHPANEL_H
+#define MOCKTOUCHPANEL_H
+
+#include "TouchPanel.h"
+#include "hostTraces.h"
+
+class MockTouchPanel : public StaticTouchPanel<MockTouchPanel>
+{
+public:
+
+    MockTouchPanel(const trace_t &trace) : _trace(trace)
+    {
+      _pos = 0;
+      _calibPoint = 0;
+    }
+
+    void rewind() { _pos = 0; }
+
+    bool init(uint16_t width, uint16_t height)
+    {
+      return width == TRACE_WIDTH && height == TRACE_HEIGHT;
+    }
+
+    bool read(TouchPanel::touchCoordinate_t &coord)
+    {
+      if (_pos >= _trace.size()) return false;
+      coord.x = _trace[_pos].x;
+      coord.y = _trace[_pos].y;
+      coord.z = _trace[_pos].touched ? 1 : 0;
+      _pos++;
+      return true;
+    }
+
+    bool calibrateStart()
+    {
+      _calibPoint = 0;
+      return true;
+    }
+
+    bool getNextCalibratePoint(uint16_t* x, uint16_t* y)
+    {
+      *x = (_calibPoint & 1) ? TRACE_WIDTH-1 : 0;
+      *y = (_calibPoint & 2) ? TRACE_HEIGHT-1 : 0;
+      return _calibPoint < 4;
+    }
+
+    bool waitForCalibratePoint(bool* morePoints, uint32_t)
+    {
+      _calibPoint++;
+      *morePoints = _calibPoint < 4;
+      return true;
+    }
+
+private:
+
+    const trace_t &_trace;
+    size_t _pos;
+    uint8_t _calibPoint;
+};
+
+#endif
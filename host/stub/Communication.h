@@ -0,0 +1,25 @@
+/*
+ *  Host stand-in for the firmware's Communication class. Only the part
+ *  used by the hardware independent modules is provided; sent texts are
+ *  kept for inspection by the tests.
+ */
+
+#ifndef COMMUNICATION_H
+#define COMMUNICATION_H
+
+#include <string>
+#include <vector>
+
+class Communication
+{
+public:
+
+    void sendInfo(const char *text, const char *target)
+    {
+        sent.push_back(std::string(target) + ":" + text);
+    }
+
+    std::vector<std::string> sent;
+};
+
+#endif
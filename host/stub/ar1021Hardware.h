@@ -0,0 +1,40 @@
+/*
+ *  Host stand-in for the pin assignment of the AR1021. The SIQ input
+ *  reads the state of the simulated controller in hostAr1021.h.
+ */
+
+#ifndef AR1021HARDWARE_H
+#define AR1021HARDWARE_H
+
+#include <stdint.h>
+#include <util/delay.h>
+
+#include "spi_driver.h"
+#include "hostAr1021.h"
+
+#define AR1021_INT_PIN (1<<2)
+#define AR1021_CS      (1<<4)
+
+// reading IN gives the SIQ line of the simulated controller
+struct HostSiqPin
+{
+    operator uint8_t() const { return hostAr1021.pollSiq() ? AR1021_INT_PIN : 0; }
+};
+
+typedef struct
+{
+    uint8_t DIR;
+    uint8_t DIRSET;
+    uint8_t DIRCLR;
+    uint8_t OUT;
+    uint8_t OUTSET;
+    uint8_t OUTCLR;
+    HostSiqPin IN;
+} PORT_t;
+
+extern PORT_t AR1021_INT_PORT;
+extern PORT_t AR1021_CS_PORT;
+extern PORT_t AR1021_SPI_PORT;
+extern SPI_t  AR1021_SPI;
+
+#endif
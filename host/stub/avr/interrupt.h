@@ -0,0 +1,12 @@
+/*
+ *  Host stand-in for <avr/interrupt.h>. The host tests call the
+ *  interrupt handlers of the driver directly, so there is nothing to mask.
+ */
+
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+static inline void cli() {}
+static inline void sei() {}
+
+#endif
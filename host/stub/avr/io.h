@@ -0,0 +1,11 @@
+/*
+ *  Host stand-in for <avr/io.h>. The ports used by the driver are
+ *  declared in ar1021Hardware.h.
+ */
+
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+#include <stdint.h>
+
+#endif
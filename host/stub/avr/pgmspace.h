@@ -0,0 +1,11 @@
+/*
+ *  Host stand-in for <avr/pgmspace.h>, flash and RAM are the same.
+ */
+
+#ifndef AVR_PGMSPACE_H
+#define AVR_PGMSPACE_H
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+#endif
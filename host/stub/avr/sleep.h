@@ -0,0 +1,15 @@
+/*
+ *  Host stand-in for <avr/sleep.h>, sleeping returns at once.
+ */
+
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE (0)
+
+static inline void set_sleep_mode(int) {}
+static inline void sleep_enable() {}
+static inline void sleep_disable() {}
+static inline void sleep_cpu() {}
+
+#endif
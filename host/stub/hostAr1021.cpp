@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "ar1021Hardware.h"
+#include "hostAr1021.h"
+
+
+HostAr1021 hostAr1021;
+
+PORT_t AR1021_INT_PORT;
+PORT_t AR1021_CS_PORT;
+PORT_t AR1021_SPI_PORT;
+SPI_t  AR1021_SPI;
+
+
+void HostAr1021::reset()
+{
+  _miso.clear();
+  _cmdLen = 0;
+  _selected = false;
+  _reading = false;
+  transfers = 0;
+  commands = 0;
+}
+
+void HostAr1021::setCommandHandler(commandHandler_t handler, void *ctx)
+{
+  _handler = handler;
+  _ctx = ctx;
+}
+
+void HostAr1021::attachTimer(volatile TIMER *timer)
+{
+  _timer = timer;
+}
+
+void HostAr1021::queue(const uint8_t *bytes, uint16_t len)
+{
+  _miso.insert(_miso.end(), bytes, bytes+len);
+}
+
+// response frame: 0x55 len status cmd data, len counts status, cmd and data
+void HostAr1021::respond(uint8_t cmd, uint8_t status, const uint8_t *data, uint8_t len)
+{
+  uint8_t head[4] = { 0x55, (uint8_t)(len + 2), status, cmd };
+  queue(head, sizeof(head));
+  if (data != 0)
+    queue(data, len);
+  else
+    _miso.insert(_miso.end(), len, 0);
+}
+
+bool HostAr1021::pollSiq()
+{
+  if (!_miso.empty()) return true;
+
+  if (_timer != 0 && _timer->state == TM_START) {
+    if (_timer->value > 0) _timer->value--;
+    if (_timer->value == 0) _timer->state = TM_STOP;
+  }
+  return false;
+}
+
+// the rest of a frame which was started is lost with chip select
+void HostAr1021::select(bool selected)
+{
+  if (!selected) {
+    _cmdLen = 0;
+    if (_reading) _miso.clear();
+  }
+  _reading = false;
+  _selected = selected;
+}
+
+uint8_t HostAr1021::transfer(uint8_t mosi)
+{
+  transfers++;
+
+  // a pending response or touch packet is clocked out, the driver sends 0
+  if (!_miso.empty()) {
+    uint8_t b = _miso.front();
+    _miso.pop_front();
+    _reading = true;
+    return b;
+  }
+
+  // collect a command frame: 0x55 len cmd data
+  if (_cmdLen == 0 && mosi != 0x55) return 0;
+  if (_cmdLen < sizeof(_cmd)) _cmd[_cmdLen++] = mosi;
+  if (_cmdLen >= 3 && _cmdLen == _cmd[1] + 2) {
+    commands++;
+    _cmdLen = 0;
+    if (_handler != 0)
+      _handler(_cmd[2], &_cmd[3], _cmd[1] - 1, _ctx);
+    else
+      respond(_cmd[2], 0, 0, 0);
+  }
+  return 0;
+}
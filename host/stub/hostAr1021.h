@@ -0,0 +1,68 @@
+/*
+ *  Simulated AR1021 on the host side of the SPI bus.
+ *
+ *  Bytes queued with queue() or respond() are returned by the following
+ *  transfers; SIQ is high while any are pending. Commands written by the
+ *  driver (0x55 len cmd data) are passed to the command handler, which
+ *  answers with respond(). Without a handler every command is answered
+ *  with status OK and no data. A frame the driver stops reading early is
+ *  discarded when chip select is released.
+ *
+ *  Every read of a low SIQ advances the attached timer by 1 ms, so the
+ *  timeouts of the driver expire while it polls the line.
+ */
+
+#ifndef HOSTAR1021_H
+#define HOSTAR1021_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <deque>
+
+#include "timer.h"
+
+class HostAr1021
+{
+public:
+
+    typedef void (*commandHandler_t)(uint8_t cmd, const uint8_t *data, uint8_t len, void *ctx);
+
+    HostAr1021()
+    {
+      _handler = 0;
+      _ctx = 0;
+      _timer = 0;
+      reset();
+    }
+
+    void reset();
+    void setCommandHandler(commandHandler_t handler, void *ctx);
+    void attachTimer(volatile TIMER *timer);
+
+    void queue(const uint8_t *bytes, uint16_t len);
+    void respond(uint8_t cmd, uint8_t status, const uint8_t *data, uint8_t len);
+    void flush() { _miso.clear(); }
+
+    bool pollSiq();
+    void select(bool selected);
+    uint8_t transfer(uint8_t mosi);
+
+    uint32_t transfers;
+    uint32_t commands;
+
+private:
+
+    commandHandler_t _handler;
+    void            *_ctx;
+    volatile TIMER  *_timer;
+
+    std::deque<uint8_t> _miso;
+    uint8_t _cmd[64];
+    uint8_t _cmdLen;
+    bool    _selected;
+    bool    _reading;       // MISO bytes were clocked out since select
+};
+
+extern HostAr1021 hostAr1021;
+
+#endif
@@ -0,0 +1,8 @@
+/*
+ *  Host stand-in for the LED pins of the board, unused by the driver.
+ */
+
+#ifndef LEDHARDWARE_H
+#define LEDHARDWARE_H
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ *  Host stand-in for spiDevice. All transfers go to the simulated AR1021
+ *  in hostAr1021.h.
+ */
+
+#ifndef SPIDEVICE_H
+#define SPIDEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ar1021Hardware.h"
+
+class spiDevice
+{
+public:
+
+    spiDevice(SPI_t *spi, PORT_t *spiPort, PORT_t *csPort, uint8_t csPin, bool lsbFirst,
+              SPI_MODE_t mode, SPI_INTLVL_t intLevel, bool clk2x, SPI_PRESCALER_t clockDivision)
+    {
+      (void)spi; (void)spiPort; (void)csPort; (void)csPin; (void)lsbFirst;
+      (void)mode; (void)intLevel; (void)clk2x; (void)clockDivision;
+    }
+
+    void select() { hostAr1021.select(true); }
+    void unselect() { hostAr1021.select(false); }
+    uint8_t transceiveByte(uint8_t data) { return hostAr1021.transfer(data); }
+};
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ *  Host stand-in for the XMEGA SPI driver types used by spiDevice.
+ */
+
+#ifndef SPI_DRIVER_H
+#define SPI_DRIVER_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint8_t CTRL;
+    uint8_t INTCTRL;
+    uint8_t STATUS;
+    uint8_t DATA;
+} SPI_t;
+
+typedef enum
+{
+    SPI_INTLVL_OFF_gc = 0,
+    SPI_INTLVL_LO_gc  = 1,
+    SPI_INTLVL_MED_gc = 2,
+    SPI_INTLVL_HI_gc  = 3,
+} SPI_INTLVL_t;
+
+typedef enum
+{
+    SPI_PRESCALER_DIV4_gc   = 0,
+    SPI_PRESCALER_DIV16_gc  = 1,
+    SPI_PRESCALER_DIV64_gc  = 2,
+    SPI_PRESCALER_DIV128_gc = 3,
+} SPI_PRESCALER_t;
+
+typedef enum
+{
+    SPI_MODE_0_gc = 0x00,
+    SPI_MODE_1_gc = 0x04,
+    SPI_MODE_2_gc = 0x08,
+    SPI_MODE_3_gc = 0x0C,
+} SPI_MODE_t;
+
+#endif
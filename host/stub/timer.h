@@ -0,0 +1,21 @@
+/*
+ *  Host stand-in for the software timers of the firmware. A timer
+ *  counts value down in ms while started and stops at 0; on the host the
+ *  simulated AR1021 advances the attached timer (see hostAr1021.h).
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#define TM_STOP  (0)
+#define TM_START (1)
+
+typedef struct
+{
+    uint32_t value;
+    uint8_t  state;
+} TIMER;
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ *  Host stand-in for <util/atomic.h>, the block runs once.
+ */
+
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+#define ATOMIC_RESTORESTATE (0)
+#define ATOMIC_FORCEON      (1)
+
+#define ATOMIC_BLOCK(type) for (int hostAtomicOnce = 1; hostAtomicOnce; hostAtomicOnce = 0)
+
+#endif
@@ -0,0 +1,11 @@
+/*
+ *  Host stand-in for <util/delay.h>, delays are not simulated.
+ */
+
+#ifndef UTIL_DELAY_H
+#define UTIL_DELAY_H
+
+static inline void _delay_us(double) {}
+static inline void _delay_ms(double) {}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ *  Tests of the AR1021 driver on the simulated SPI bus, and of the
+ *  replay of its recordings through DriverReplay.
+ */
+
+#include <stdlib.h>
+#include <vector>
+
+#include "ar1021.h"
+#include "driverReplay.h"
+#include "hostAr1021.h"
+#include "hostTest.h"
+#include "hostTraces.h"
+
+static volatile TIMER timeout;
+
+typedef struct
+{
+    int16_t x, y;
+    bool    touched;
+} event_t;
+
+static void failCommand(uint8_t cmd, const uint8_t *, uint8_t, void *ctx)
+{
+    uint8_t failing = *(uint8_t*)ctx;
+    hostAr1021.respond(cmd, cmd == failing ? AR1021_RESP_STAT_CMD_UNREC : AR1021_RESP_STAT_OK,
+                       NULL, 0);
+}
+
+static void ignoreCommand(uint8_t, const uint8_t *, uint8_t, void *)
+{
+}
+
+// clock a trace into the driver, one packet per sample
+static std::vector<event_t> feed(AR1021 &driver, const trace_t &trace)
+{
+    std::vector<event_t> events;
+    uint8_t packet[AR1021_PACKET_SIZE];
+    AR1021::touchCoordinate_t coord;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        while (driver.ticks() != trace[i].t)
+            driver.tick();
+        traceToPacket(trace[i], TRACE_WIDTH, TRACE_HEIGHT, packet);
+        hostAr1021.queue(packet, sizeof(packet));
+        driver.readTouchIrq();
+        if (driver.read(coord)) {
+            event_t e = { coord.x, coord.y, coord.touched };
+            events.push_back(e);
+        }
+    }
+    return events;
+}
+
+static void testInit()
+{
+    hostAr1021.reset();
+    hostAr1021.setCommandHandler(NULL, NULL);
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+
+    CHECK(driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    // disable, register offset, 3 registers, eeprom, enable
+    CHECK_EQ(hostAr1021.commands, 7);
+}
+
+static void testInitError()
+{
+    uint8_t failing = AR1021_CMD_ENABLE_TOUCH;
+    hostAr1021.reset();
+    hostAr1021.setCommandHandler(failCommand, &failing);
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+
+    CHECK(!driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    // two attempts of the whole sequence
+    CHECK_EQ(hostAr1021.commands, 14);
+    hostAr1021.setCommandHandler(NULL, NULL);
+}
+
+// SIQ never rises, the timer ends every wait
+static void testTimeout()
+{
+    hostAr1021.reset();
+    hostAr1021.setCommandHandler(ignoreCommand, NULL);
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+
+    CHECK(!driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    CHECK_EQ(hostAr1021.commands, 2);
+    hostAr1021.setCommandHandler(NULL, NULL);
+}
+
+static void testPackets()
+{
+    hostAr1021.reset();
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    CHECK(driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+
+    trace_t trace;
+    tracePush(trace, 100, 100, true);
+    tracePush(trace, 100, 100, true);     // repeated, not reported
+    tracePush(trace, 300, 200, true);
+    tracePenUp(trace);
+
+    uint8_t seq = driver.sequence();
+    std::vector<event_t> events = feed(driver, trace);
+    CHECK_EQ((uint8_t)(driver.sequence() - seq), 2*trace.size());
+    CHECK_EQ(events.size(), 3);
+    if (events.size() == 3) {
+        CHECK(abs(events[0].x - 100) <= 1 && abs(events[0].y - 100) <= 1);
+        CHECK(events[0].touched);
+        CHECK(abs(events[1].x - 300) <= 1 && abs(events[1].y - 200) <= 1);
+        CHECK(!events[2].touched);
+    }
+    // every byte of a packet was clocked over the bus
+    CHECK(hostAr1021.transfers >= trace.size() * AR1021_PACKET_SIZE);
+}
+
+// a recorded session replayed through a second driver gives the same events
+static void testRecordReplay()
+{
+    TouchRecorder rec;
+    trace_t trace = traceScribble(1);
+    trace.resize(40);
+    tracePenUp(trace);
+
+    hostAr1021.reset();
+    AR1021 recorded(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    recorded.setRecorder(&rec);
+    rec.start();
+    CHECK(recorded.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    std::vector<event_t> expected = feed(recorded, trace);
+    rec.stop();
+    CHECK_EQ(rec.dropped(), 0);
+
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    DriverReplay replay(driver, rec.data(), rec.length());
+    CHECK(replay.recordedInit());
+    CHECK(driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    CHECK_EQ(replay.commandsReplayed, 7);
+
+    std::vector<event_t> events;
+    AR1021::touchCoordinate_t coord;
+    uint16_t t;
+    while (replay.next(t)) {
+        if (driver.read(coord)) {
+            event_t e = { coord.x, coord.y, coord.touched };
+            events.push_back(e);
+        }
+    }
+    CHECK_EQ(replay.packets, trace.size());
+    CHECK_EQ(events.size(), expected.size());
+    for (size_t i = 0; i < events.size() && i < expected.size(); i++) {
+        CHECK_EQ(events[i].x, expected[i].x);
+        CHECK_EQ(events[i].y, expected[i].y);
+        CHECK_EQ(events[i].touched, expected[i].touched);
+    }
+    CHECK_EQ(replay.commandsMissing, 0);
+    CHECK_EQ(replay.commandsMismatched, 0);
+}
+
+// a recorded command error fails init() again on replay
+static void testReplayError()
+{
+    TouchRecorder rec;
+    uint8_t failing = AR1021_CMD_REGISTER_WRITE_TO_EEPROM;
+
+    hostAr1021.reset();
+    hostAr1021.setCommandHandler(failCommand, &failing);
+    AR1021 recorded(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    recorded.setRecorder(&rec);
+    rec.start();
+    CHECK(!recorded.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    rec.stop();
+
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    DriverReplay replay(driver, rec.data(), rec.length());
+    CHECK(!driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    CHECK_EQ(replay.commandsReplayed, 12);
+    CHECK_EQ(replay.commandsMissing, 0);
+    CHECK_EQ(replay.commandsMismatched, 0);
+}
+
+int main()
+{
+    hostAr1021.attachTimer(&timeout);
+    testInit();
+    testInitError();
+    testTimeout();
+    testPackets();
+    testRecordReplay();
+    testReplayError();
+    return hostResult("test_ar1021");
+}
@@ -0,0 +1,100 @@
+/*
+ *  Tests of HitGrid and HitTracker.
+ */
+
+#include "hitGrid.h"
+#include "hostTest.h"
+
+typedef HitGrid<8, 6, 8, 2> grid_t;
+
+static const hitRect_t layout[] = {
+    {   0,   0, 100, 100 },
+    {  50,  50, 300, 200 },     // overlaps region 0
+    { -10, 400, 810, 490 },     // extends beyond the panel
+    { 700,   0, 800, 480 },
+    { 120, 120, 120, 300 },     // empty
+};
+
+static constexpr grid_t staticGrid(800, 480, layout);
+static_assert(staticGrid.complete(), "layout must fit into the slots");
+
+// the compile-time index answers like the one built at runtime
+static void testStaticBuild()
+{
+    grid_t grid(800, 480);
+    CHECK(grid.build(layout, sizeof(layout)/sizeof(layout[0])));
+    for (int16_t y = -2; y < 490; y++) {
+        for (int16_t x = -2; x < 810; x++) {
+            if (grid.find(x, y) != staticGrid.find(x, y)) {
+                CHECK_EQ(grid.find(x, y), staticGrid.find(x, y));
+                return;
+            }
+        }
+    }
+    CHECK_EQ(staticGrid.find(60, 60), 1);
+    CHECK_EQ(staticGrid.find(10, 10), 0);
+    CHECK_EQ(staticGrid.find(400, 479), 2);
+    CHECK_EQ(staticGrid.find(799, 479), 3);
+    CHECK_EQ(staticGrid.find(120, 250), HIT_NONE);
+}
+
+// a region which does not fit is removed from all of its cells
+static void testRollback()
+{
+    grid_t grid(800, 480);
+    hitRect_t a = { 0, 0, 800, 80 };
+    hitRect_t wide = { 0, 0, 800, 480 };
+
+    CHECK(grid.setRegion(0, a));
+    CHECK(grid.setRegion(1, a));
+    CHECK(!grid.setRegion(2, wide));
+    CHECK(!grid.complete());
+    CHECK_EQ(grid.find(400, 40), 1);
+    CHECK_EQ(grid.find(400, 300), HIT_NONE);
+
+    // the slots are free again for a region which fits
+    hitRect_t b = { 0, 100, 800, 480 };
+    CHECK(grid.setRegion(2, b));
+    CHECK_EQ(grid.find(400, 300), 2);
+
+    grid.clear();
+    CHECK(grid.complete());
+}
+
+static void testZeroSize()
+{
+    grid_t grid(0, 0);
+    hitRect_t a = { 10, 10, 20, 20 };
+    CHECK(grid.setRegion(0, a));
+    CHECK_EQ(grid.find(15, 15), 0);
+    CHECK_EQ(grid.find(25, 15), HIT_NONE);
+}
+
+static void testTracker()
+{
+    HitTracker tracker;
+    hitEvent_t events[HIT_MAX_EVENTS];
+
+    CHECK_EQ(tracker.update(1, true, events), 2);
+    CHECK_EQ(events[0].type, HIT_EVENT_ENTER);
+    CHECK_EQ(events[1].type, HIT_EVENT_PRESS);
+    CHECK_EQ(tracker.update(1, true, events), 0);
+    CHECK_EQ(tracker.update(2, true, events), 2);
+    CHECK_EQ(events[0].type, HIT_EVENT_LEAVE);
+    CHECK_EQ(events[0].region, 1);
+    CHECK_EQ(events[1].type, HIT_EVENT_ENTER);
+    CHECK_EQ(events[1].region, 2);
+    CHECK_EQ(tracker.update(2, false, events), 2);
+    CHECK_EQ(events[0].type, HIT_EVENT_RELEASE);
+    CHECK_EQ(events[1].type, HIT_EVENT_LEAVE);
+    CHECK_EQ(tracker.current(), HIT_NONE);
+}
+
+int main()
+{
+    testStaticBuild();
+    testRollback();
+    testZeroSize();
+    testTracker();
+    return hostResult("test_hitGrid");
+}
@@ -0,0 +1,215 @@
+/*
+ *  Round-trip tests of InkCapture and InkDecoder.
+ */
+
+#include <math.h>
+#include <vector>
+
+#include "inkCapture.h"
+#include "hostTest.h"
+#include "hostTraces.h"
+
+typedef struct { int16_t x, y; } point_t;
+typedef std::vector<point_t> stroke_t;
+
+struct decoded_t
+{
+    std::vector<stroke_t> strokes;
+    int  unterminated;      // points arriving after a closed stroke without a start
+    bool open;
+};
+
+static void onPoint(int16_t x, int16_t y, bool start, void *ctx)
+{
+    decoded_t *d = (decoded_t*)ctx;
+    if (start) {
+        if (d->open) d->unterminated++;
+        d->strokes.push_back(stroke_t());
+        d->open = true;
+    }
+    point_t p = { x, y };
+    d->strokes.back().push_back(p);
+}
+
+static void onStrokeEnd(void *ctx)
+{
+    ((decoded_t*)ctx)->open = false;
+}
+
+// feed a trace and decode the stream, chunk selects the drain size
+static decoded_t roundTrip(InkCapture &ink, const trace_t &trace, uint8_t chunk)
+{
+    decoded_t d;
+    d.unterminated = 0;
+    d.open = false;
+    InkDecoder dec(onPoint, onStrokeEnd, &d);
+    uint8_t buf[255];
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        ink.addSample(trace[i].x, trace[i].y, trace[i].touched);
+        uint8_t n;
+        while ((n = ink.readBytes(buf, chunk)) > 0)
+            dec.feed(buf, n);
+    }
+    return d;
+}
+
+static double segmentDistance(double px, double py, const point_t &a, const point_t &b)
+{
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double len2 = dx*dx + dy*dy;
+    double t = len2 > 0 ? ((px-a.x)*dx + (py-a.y)*dy) / len2 : 0;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    return hypot(px - (a.x + t*dx), py - (a.y + t*dy));
+}
+
+// largest distance of a touched input sample to the decoded polyline
+static double maxError(const trace_t &trace, const decoded_t &d)
+{
+    double worst = 0;
+    size_t stroke = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        if (!trace[i].touched) {
+            stroke++;
+            continue;
+        }
+        if (stroke >= d.strokes.size()) return 1e9;
+        const stroke_t &s = d.strokes[stroke];
+        double best = hypot(trace[i].x - s[0].x, trace[i].y - s[0].y);
+        for (size_t k = 1; k < s.size(); k++) {
+            double e = segmentDistance(trace[i].x, trace[i].y, s[k-1], s[k]);
+            if (e < best) best = e;
+        }
+        if (best > worst) worst = best;
+    }
+    return worst;
+}
+
+static void testBackAndForth()
+{
+    InkCapture ink;
+    trace_t trace;
+    tracePush(trace, 100, 100, true);
+    tracePush(trace, 110, 100, true);
+    tracePush(trace, 100, 100, true);
+    tracePenUp(trace);
+    tracePush(trace, 200, 200, true);
+    tracePush(trace, 220, 200, true);
+    tracePenUp(trace);
+
+    decoded_t d = roundTrip(ink, trace, 255);
+    CHECK_EQ(d.strokes.size(), 2);
+    CHECK_EQ(d.unterminated, 0);
+    CHECK(!d.open);
+    if (d.strokes.size() == 2) {
+        CHECK_EQ(d.strokes[0].size(), 3);
+        CHECK_EQ(d.strokes[0][1].x, 110);
+        CHECK_EQ(d.strokes[0][2].x, 100);
+        CHECK_EQ(d.strokes[1][0].x, 200);
+        CHECK_EQ(d.strokes[1].back().x, 220);
+    }
+}
+
+static void testStartOnPreviousEnd()
+{
+    // the first point of a stroke may have a zero delta
+    InkCapture ink;
+    trace_t trace;
+    tracePush(trace, 50, 50, true);
+    tracePush(trace, 80, 50, true);
+    tracePenUp(trace);
+    tracePush(trace, 80, 50, true);
+    tracePush(trace, 80, 90, true);
+    tracePenUp(trace);
+
+    decoded_t d = roundTrip(ink, trace, 255);
+    CHECK_EQ(d.strokes.size(), 2);
+    CHECK_EQ(d.unterminated, 0);
+    if (d.strokes.size() == 2) {
+        CHECK_EQ(d.strokes[1][0].x, 80);
+        CHECK_EQ(d.strokes[1][0].y, 50);
+    }
+}
+
+static void testErrorBound(const char *name, const trace_t &trace, uint8_t radial, uint8_t deviation)
+{
+    InkCapture ink;
+    ink.setTolerance(radial, deviation);
+    decoded_t d = roundTrip(ink, trace, 7);
+
+    size_t strokes = 0;
+    for (size_t i = 0; i < trace.size(); i++)
+        if (!trace[i].touched) strokes++;
+
+    double err = maxError(trace, d);
+    printf("  %-10s %4u -> %3u points, max error %.2f\n", name, ink.pointsIn, ink.pointsOut, err);
+    CHECK_EQ(d.strokes.size(), strokes);
+    CHECK_EQ(d.unterminated, 0);
+    CHECK_EQ(ink.pointsLost, 0);
+    CHECK(err <= radial + deviation + 0.01);
+}
+
+static void testBufferFull()
+{
+    // never drained until the end: points are lost, but the stream stays
+    // decodable and in phase
+    InkCapture ink;
+    ink.setTolerance(1, 0);
+    trace_t trace = traceScribble(6);
+    for (size_t i = 0; i < trace.size(); i++)
+        ink.addSample(trace[i].x, trace[i].y, trace[i].touched);
+    CHECK(ink.pointsLost > 0);
+
+    decoded_t d;
+    d.unterminated = 0;
+    d.open = false;
+    InkDecoder dec(onPoint, onStrokeEnd, &d);
+    uint8_t buf[INK_BUFFER_SIZE];
+    uint8_t n = ink.readBytes(buf, sizeof(buf));
+    dec.feed(buf, n);
+    CHECK_EQ(d.unterminated, 0);
+    CHECK(!d.open);
+}
+
+// an over-long varint is dropped and the stream continues with a stroke
+static void testLongVarint()
+{
+    decoded_t d;
+    d.unterminated = 0;
+    d.open = false;
+    InkDecoder dec(onPoint, onStrokeEnd, &d);
+
+    // point (10,20), then dx with a corrupted 3rd byte, then point (+1,+1)
+    const uint8_t stream[] = { 20, 40, 0x82, 0x80, 0x80, 2, 2 };
+    dec.feed(stream, sizeof(stream));
+    CHECK_EQ(dec.errors, 1);
+    CHECK(d.open);
+    CHECK_EQ(d.strokes.size(), 2);
+    if (d.strokes.size() == 2) {
+        CHECK_EQ(d.strokes[0][0].x, 10);
+        CHECK_EQ(d.strokes[0][0].y, 20);
+        CHECK_EQ(d.strokes[1][0].x, 11);
+        CHECK_EQ(d.strokes[1][0].y, 21);
+    }
+
+    // a run of continuation bytes never shifts beyond 16 bits
+    dec.reset();
+    uint8_t run[40];
+    for (size_t i = 0; i < sizeof(run); i++) run[i] = 0xFF;
+    dec.feed(run, sizeof(run));
+    CHECK_EQ(dec.errors, (int)sizeof(run)/INK_MAX_VARINT_BYTES);
+}
+
+int main()
+{
+    testBackAndForth();
+    testStartOnPreviousEnd();
+    testErrorBound("semicircle", traceSemicircle(100, 2000), 1, 1);
+    testErrorBound("signature", traceSignature(12), 2, 1);
+    testErrorBound("scribble", traceScribble(4), 2, 1);
+    testErrorBound("coarse", traceSignature(12), 4, 3);
+    testBufferFull();
+    testLongVarint();
+    return hostResult("test_inkCapture");
+}
@@ -0,0 +1,153 @@
+/*
+ *  Tests of the coalescing in AR1021::read() on jitter traces. The traces
+ *  are clocked into the driver over the simulated SPI bus.
+ *
+ *  usage: test_touchCoalescer [trace.txt ...]
+ *
+ *  The given recorded traces are checked in addition to the generated
+ *  ones.
+ */
+
+#include "ar1021.h"
+#include "touchCoalescer.h"
+#include "hostAr1021.h"
+#include "hostTest.h"
+#include "hostTraces.h"
+
+typedef struct
+{
+    uint32_t changes;       // samples differing from the previous report
+    uint32_t reports;
+    uint16_t maxGap;        // longest time between reports while touched
+    uint16_t suppressed;
+} coalesceResult_t;
+
+static volatile TIMER timeout;
+
+// one packet per sample, read() polled after each; the driver ticks
+// along with the trace if timed
+static coalesceResult_t run(const trace_t &trace, uint8_t minDistance, uint16_t minInterval,
+                            uint16_t maxLatency, bool timed)
+{
+    coalesceResult_t res = { 0, 0, 0, 0 };
+    traceSample_t last = { 0, 0, 0, false };
+    uint16_t lastReport = 0;
+    uint8_t packet[AR1021_PACKET_SIZE];
+    AR1021::touchCoordinate_t coord;
+
+    hostAr1021.reset();
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    CHECK(driver.init(TRACE_WIDTH, TRACE_HEIGHT, false));
+    driver.setCoalescing(minDistance, minInterval, maxLatency);
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        const traceSample_t &s = trace[i];
+        while (timed && driver.ticks() != s.t)
+            driver.tick();
+        traceToPacket(s, TRACE_WIDTH, TRACE_HEIGHT, packet);
+        hostAr1021.queue(packet, sizeof(packet));
+        driver.readTouchIrq();
+
+        bool changed = s.x != last.x || s.y != last.y || s.touched != last.touched;
+        if (changed) res.changes++;
+        if (!driver.read(coord)) {
+            CHECK(s.touched == last.touched);
+            continue;
+        }
+        CHECK(changed);
+        CHECK_EQ(coord.x, s.x);
+        CHECK_EQ(coord.y, s.y);
+        if (s.touched && last.touched && (uint16_t)(s.t - lastReport) > res.maxGap)
+            res.maxGap = s.t - lastReport;
+        res.reports++;
+        last = s;
+        lastReport = s.t;
+    }
+    res.suppressed = driver.suppressedEvents();
+    return res;
+}
+
+// a resting finger with +-1 px jitter is reduced to a few reports
+static void testResting()
+{
+    trace_t trace = traceResting(400, 100, 1);
+
+    coalesceResult_t all = run(trace, 0, 0, 0, true);
+    coalesceResult_t few = run(trace, 3, 20, 100, true);
+
+    printf("  resting: %u changes, %u reported, max gap %u ms\n",
+           all.reports, few.reports, few.maxGap);
+    CHECK_EQ(all.reports, all.changes);
+    CHECK_EQ(all.suppressed, 0);
+    CHECK(few.reports * 5 < all.reports);
+    CHECK_EQ(few.suppressed, few.changes - few.reports);
+    // maxLatency holds up to one report interval
+    CHECK(few.maxGap <= 100 + TRACE_INTERVAL);
+}
+
+// moves of a drag still arrive, at most every minInterval
+static void testDrag()
+{
+    trace_t trace = traceResting(0, 200, 0);
+
+    coalesceResult_t res = run(trace, 3, 20, 100, true);
+    CHECK(res.reports >= 200 * TRACE_INTERVAL / 20 - 1);
+    CHECK(res.reports <= 200 * TRACE_INTERVAL / 20 + 2);
+}
+
+// without a time base only the distance counts
+static void testUntimed()
+{
+    trace_t trace = traceResting(0, 200, 0);
+
+    // tick() is never called
+    coalesceResult_t res = run(trace, 3, 20, 100, false);
+    CHECK(res.reports >= 200 / 2 - 1);
+}
+
+// a sample offered again by a later poll is counted once
+static void testCountOnce()
+{
+    TouchCoalescer co;
+    co.configure(3, 0, 0);
+    CHECK(co.accept(10, 10, true, 2, 0, true));
+    CHECK(!co.accept(11, 10, true, 4, 5, true));
+    CHECK(!co.accept(11, 10, true, 4, 6, true));
+    CHECK(!co.accept(11, 11, true, 6, 7, true));
+    CHECK_EQ(co.suppressed, 2);
+    CHECK(co.accept(11, 11, false, 8, 8, true));
+}
+
+// every change is either reported or counted as suppressed, pen down
+// and pen up always pass (checked in run())
+static void testRecorded(const char *name, const trace_t &trace)
+{
+    coalesceResult_t all = run(trace, 0, 0, 0, true);
+    coalesceResult_t few = run(trace, 3, 20, 100, true);
+
+    printf("  %s: %u changes, %u reported, max gap %u ms\n",
+           name, all.reports, few.reports, few.maxGap);
+    CHECK_EQ(all.reports, all.changes);
+    CHECK_EQ(all.suppressed, 0);
+    CHECK_EQ(few.suppressed, few.changes - few.reports);
+}
+
+int main(int argc, char **argv)
+{
+    hostAr1021.attachTimer(&timeout);
+
+    for (int i = 1; i < argc; i++) {
+        trace_t trace = traceLoad(argv[i]);
+        if (trace.empty()) {
+            printf("%s: no samples\n", argv[i]);
+            return 1;
+        }
+        testRecorded(argv[i], trace);
+    }
+
+    testResting();
+    testDrag();
+    testUntimed();
+    testCountOnce();
+    return hostResult("test_touchCoalescer");
+}
@@ -0,0 +1,107 @@
+/*
+ *  Accuracy of TouchCorrection on a panel with a smooth nonlinearity.
+ *
+ *  The simulated panel bends the true position by up to ~20 px, like a
+ *  resistive panel with uneven coating. After the mesh calibration with
+ *  the bent positions of the targets, the corrected position of every
+ *  point of the panel is compared to the true one.
+ */
+
+#include <math.h>
+
+#include "touchCorrection.h"
+#include "hostTest.h"
+#include "hostTraces.h"
+
+// error of the interpolation between the mesh points, in pixels
+#define MAX_ERROR_INSIDE (3)
+
+static void distort(int16_t x, int16_t y, int16_t &mx, int16_t &my)
+{
+    double u = (double)x / TRACE_WIDTH - 0.5;
+    double v = (double)y / TRACE_HEIGHT - 0.5;
+    mx = (int16_t)lround(x + 60*u*(u*u + v*v) + 8*sin(v*3));
+    my = (int16_t)lround(y + 40*v*(u*u + v*v) - 6*sin(u*3));
+}
+
+static void calibrate(TouchCorrection &corr)
+{
+    uint16_t tx, ty;
+    bool more = true;
+
+    corr.init(TRACE_WIDTH, TRACE_HEIGHT);
+    CHECK(corr.calibrateStart());
+    while (more && corr.getNextCalibratePoint(&tx, &ty)) {
+        int16_t mx, my;
+        distort(tx, ty, mx, my);
+        CHECK(corr.addCalibratePoint(mx, my, &more));
+    }
+    CHECK(corr.isValid());
+}
+
+static void testAccuracy()
+{
+    TouchCorrection corr;
+    calibrate(corr);
+
+    // outer mesh points, see TouchCorrection::init()
+    int16_t x0 = TRACE_WIDTH * TOUCH_MESH_DEFAULT_INSET / 200;
+    int16_t y0 = TRACE_HEIGHT * TOUCH_MESH_DEFAULT_INSET / 200;
+    int16_t x1 = TRACE_WIDTH - x0;
+    int16_t y1 = TRACE_HEIGHT - y0;
+
+    int maxBefore = 0, maxAfter = 0;
+    for (int16_t y = y0; y < y1; y += 3) {
+        for (int16_t x = x0; x < x1; x += 3) {
+            int16_t mx, my;
+            distort(x, y, mx, my);
+            int before = abs(mx - x) > abs(my - y) ? abs(mx - x) : abs(my - y);
+            corr.apply(mx, my);
+            int after = abs(mx - x) > abs(my - y) ? abs(mx - x) : abs(my - y);
+            if (before > maxBefore) maxBefore = before;
+            if (after > maxAfter) maxAfter = after;
+        }
+    }
+    printf("  inside the mesh: max error %d px uncorrected, %d px corrected\n",
+           maxBefore, maxAfter);
+    CHECK(maxAfter <= MAX_ERROR_INSIDE);
+    CHECK(maxBefore > 4 * maxAfter);
+}
+
+// offsets at the edges must not move a touch off the panel
+static void testClamp()
+{
+    TouchCorrection corr;
+    int8_t data[TOUCH_MESH_DATA_SIZE];
+    for (int i = 0; i < TOUCH_MESH_DATA_SIZE; i++)
+        data[i] = (i & 1) ? -100 : 100;
+
+    corr.init(TRACE_WIDTH, TRACE_HEIGHT);
+    corr.setData(data);
+    for (int16_t x = 0; x < TRACE_WIDTH; x += 7) {
+        int16_t cx = x, cy = 0;
+        corr.apply(cx, cy);
+        CHECK(cx >= 0 && cx < TRACE_WIDTH);
+        CHECK_EQ(cy, 0);
+    }
+    int16_t cx = TRACE_WIDTH-1, cy = TRACE_HEIGHT-1;
+    corr.apply(cx, cy);
+    CHECK_EQ(cx, TRACE_WIDTH-1);
+    CHECK_EQ(cy, TRACE_HEIGHT-101);
+
+    // not active before calibration
+    TouchCorrection idle;
+    idle.init(TRACE_WIDTH, TRACE_HEIGHT);
+    cx = 10;
+    cy = 20;
+    idle.apply(cx, cy);
+    CHECK_EQ(cx, 10);
+    CHECK_EQ(cy, 20);
+}
+
+int main()
+{
+    testAccuracy();
+    testClamp();
+    return hostResult("test_touchCorrection");
+}
@@ -0,0 +1,211 @@
+/*
+ *  Tests of TouchDispatcher.
+ */
+
+#include <vector>
+
+#include "touchDispatcher.h"
+#include "hostTest.h"
+
+typedef struct
+{
+    int     id;
+    uint8_t type;
+    int16_t x;
+} delivery_t;
+
+static std::vector<delivery_t> deliveries;
+
+// the ctx of a subscriber is its id
+static void record(const dispatchEvent_t &event, void *ctx)
+{
+    delivery_t d = { (int)(intptr_t)ctx, event.type, event.x };
+    deliveries.push_back(d);
+}
+
+static void *id(int n)
+{
+    return (void*)(intptr_t)n;
+}
+
+static int countOf(int subscriber, uint8_t type)
+{
+    int n = 0;
+    for (size_t i = 0; i < deliveries.size(); i++)
+        if (deliveries[i].id == subscriber && (deliveries[i].type & type)) n++;
+    return n;
+}
+
+// down at x, moves to x+1..x+moves, up
+static void stroke(TouchDispatcher &disp, int16_t x, int moves)
+{
+    disp.publish(x, 10, true, 0);
+    for (int i = 1; i <= moves; i++)
+        disp.publish(x + i, 10, true, i);
+    disp.publish(x + moves, 10, false, moves + 1);
+}
+
+static void testPriority()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    CHECK(disp.subscribe(record, id(1), 1, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR));
+    CHECK(disp.subscribe(record, id(2), 5, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR));
+    CHECK(disp.subscribe(record, id(3), 3, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR));
+    // equal priority: in the order of subscription
+    CHECK(disp.subscribe(record, id(4), 3, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR));
+    CHECK(!disp.subscribe(record, id(5), 9, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR));
+
+    disp.publish(100, 10, true, 0);
+    CHECK_EQ(deliveries.size(), 4);
+    if (deliveries.size() == 4) {
+        CHECK_EQ(deliveries[0].id, 2);
+        CHECK_EQ(deliveries[1].id, 3);
+        CHECK_EQ(deliveries[2].id, 4);
+        CHECK_EQ(deliveries[3].id, 1);
+    }
+}
+
+static void testMasks()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    disp.subscribe(record, id(1), 0, TOUCH_EVT_DOWN, 0, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(2), 0, TOUCH_EVT_UP, 0, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(3), 0, TOUCH_EVT_MOVE, 0, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(4), 0, TOUCH_EVT_DOWN|TOUCH_EVT_UP, 0, TOUCH_DISPATCH_ISR);
+
+    stroke(disp, 100, 3);
+    // an unchanged sample and pen up while up are no events
+    disp.publish(103, 10, false, 5);
+    disp.publish(103, 10, false, 6);
+
+    CHECK_EQ(countOf(1, TOUCH_EVT_ALL), 1);
+    CHECK_EQ(countOf(1, TOUCH_EVT_DOWN), 1);
+    CHECK_EQ(countOf(2, TOUCH_EVT_ALL), 1);
+    CHECK_EQ(countOf(2, TOUCH_EVT_UP), 1);
+    CHECK_EQ(countOf(3, TOUCH_EVT_ALL), 3);
+    CHECK_EQ(countOf(3, TOUCH_EVT_MOVE), 3);
+    CHECK_EQ(countOf(4, TOUCH_EVT_ALL), 2);
+
+    // touched at the same position is no move
+    deliveries.clear();
+    disp.publish(50, 10, true, 10);
+    disp.publish(50, 10, true, 11);
+    CHECK_EQ(countOf(3, TOUCH_EVT_ALL), 0);
+}
+
+static void testDecimation()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    disp.subscribe(record, id(1), 0, TOUCH_EVT_ALL, 3, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(2), 0, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(3), 0, TOUCH_EVT_ALL, 1, TOUCH_DISPATCH_ISR);
+
+    stroke(disp, 100, 7);
+    // every 3rd move, down and up are never skipped
+    CHECK_EQ(countOf(1, TOUCH_EVT_MOVE), 2);
+    CHECK_EQ(countOf(1, TOUCH_EVT_DOWN|TOUCH_EVT_UP), 2);
+    CHECK_EQ(countOf(2, TOUCH_EVT_MOVE), 7);
+    CHECK_EQ(countOf(3, TOUCH_EVT_MOVE), 7);
+
+    // the 3rd, 6th move
+    std::vector<int16_t> xs;
+    for (size_t i = 0; i < deliveries.size(); i++)
+        if (deliveries[i].id == 1 && deliveries[i].type == TOUCH_EVT_MOVE) xs.push_back(deliveries[i].x);
+    CHECK(xs.size() == 2 && xs[0] == 103 && xs[1] == 106);
+
+    // the count carries over to the next stroke
+    deliveries.clear();
+    stroke(disp, 200, 2);
+    CHECK_EQ(countOf(1, TOUCH_EVT_MOVE), 1);
+}
+
+static void testDeferred()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    disp.subscribe(record, id(1), 0, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR);
+    disp.subscribe(record, id(2), 9, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_DEFERRED);
+
+    disp.publish(100, 10, true, 0);
+    disp.publish(101, 10, true, 1);
+    CHECK_EQ(countOf(1, TOUCH_EVT_ALL), 2);
+    CHECK_EQ(countOf(2, TOUCH_EVT_ALL), 0);
+
+    disp.process();
+    CHECK_EQ(countOf(1, TOUCH_EVT_ALL), 2);
+    CHECK_EQ(countOf(2, TOUCH_EVT_ALL), 2);
+    CHECK(deliveries.size() == 4 && deliveries[2].type == TOUCH_EVT_DOWN && deliveries[3].type == TOUCH_EVT_MOVE);
+
+    // nothing is delivered twice
+    disp.process();
+    CHECK_EQ(deliveries.size(), 4);
+}
+
+// only event types of deferred subscribers are queued
+static void testUnsubscribe()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    disp.subscribe(record, id(1), 0, TOUCH_EVT_MOVE, 0, TOUCH_DISPATCH_DEFERRED);
+    disp.subscribe(record, id(2), 0, TOUCH_EVT_DOWN|TOUCH_EVT_UP, 0, TOUCH_DISPATCH_DEFERRED);
+    disp.subscribe(record, id(3), 0, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_ISR);
+
+    disp.unsubscribe(record, id(1));
+    // unknown subscribers are ignored
+    disp.unsubscribe(record, id(7));
+
+    // far more moves than the queue holds, none of them is queued
+    stroke(disp, 100, 3*TOUCH_DISPATCH_QUEUE_SIZE);
+    CHECK_EQ(disp.queueOverflows, 0);
+    CHECK_EQ(countOf(3, TOUCH_EVT_MOVE), 3*TOUCH_DISPATCH_QUEUE_SIZE);
+
+    disp.process();
+    CHECK_EQ(countOf(1, TOUCH_EVT_ALL), 0);
+    CHECK_EQ(countOf(2, TOUCH_EVT_ALL), 2);
+
+    // without deferred subscribers nothing is queued at all
+    disp.unsubscribe(record, id(2));
+    for (int i = 0; i < 3*TOUCH_DISPATCH_QUEUE_SIZE; i++)
+        stroke(disp, 300, 0);
+    CHECK_EQ(disp.queueOverflows, 0);
+}
+
+static void testQueueOverflow()
+{
+    TouchDispatcher disp;
+    deliveries.clear();
+    disp.subscribe(record, id(1), 0, TOUCH_EVT_ALL, 0, TOUCH_DISPATCH_DEFERRED);
+
+    // one slot stays free to tell a full queue from an empty one
+    const int fits = TOUCH_DISPATCH_QUEUE_SIZE - 1;
+    disp.publish(100, 10, true, 0);
+    for (int i = 1; i < fits + 3; i++)
+        disp.publish(100 + i, 10, true, i);
+    CHECK_EQ(disp.queueOverflows, 3);
+
+    disp.process();
+    CHECK_EQ(deliveries.size(), fits);
+    // the oldest events were kept
+    CHECK(!deliveries.empty() && deliveries[0].type == TOUCH_EVT_DOWN);
+    CHECK(!deliveries.empty() && deliveries.back().x == 100 + fits - 1);
+
+    // room again after process()
+    disp.publish(100, 10, false, 20);
+    disp.process();
+    CHECK_EQ(disp.queueOverflows, 3);
+    CHECK(deliveries.back().type == TOUCH_EVT_UP);
+}
+
+int main()
+{
+    testPriority();
+    testMasks();
+    testDecimation();
+    testDeferred();
+    testUnsubscribe();
+    testQueueOverflow();
+    return hostResult("test_touchDispatcher");
+}
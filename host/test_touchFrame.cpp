@@ -0,0 +1,168 @@
+/*
+ *  Tests of the touch frame format, TouchTelemetry and the hex helper.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "touchTelemetry.h"
+#include "hostTest.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+static void collect(const uint8_t *frame, uint8_t len, void *ctx)
+{
+    bytes_t *out = (bytes_t*)ctx;
+    out->insert(out->end(), frame, frame+len);
+}
+
+static void onEvent(const touchEvent_t &event, void *ctx)
+{
+    ((std::vector<touchEvent_t>*)ctx)->push_back(event);
+}
+
+static bytes_t frame(uint16_t t0, int samples, bool seq)
+{
+    bytes_t out;
+    TouchTelemetry tel;
+    tel.setSink(collect, &out);
+    tel.setSequence(seq);
+    for (int i = 0; i < samples; i++)
+        tel.addSample(t0 + i*5, 100+i, 200-i, true);
+    tel.flush();
+    return out;
+}
+
+static void testRoundTrip()
+{
+    bytes_t out;
+    TouchTelemetry tel;
+    tel.setSink(collect, &out);
+    tel.setThresholds(4, 50);
+    for (int i = 0; i < 10; i++) {
+        tel.addSample(1000 + i*7, i*3, 479-i, i != 9);
+        tel.poll(1000 + i*7);
+    }
+    tel.flush();
+    CHECK_EQ(tel.framesSent, 3);
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    dec.feed(&out[0], out.size());
+    CHECK_EQ(dec.framesOk, 3);
+    CHECK_EQ(dec.framesBad, 0);
+    CHECK_EQ(dec.framesLost, 0);
+    CHECK_EQ(events.size(), 10);
+    for (size_t i = 0; i < events.size(); i++) {
+        CHECK_EQ(events[i].timestamp, 1000 + i*7);
+        CHECK_EQ(events[i].x, i*3);
+        CHECK_EQ(events[i].y, 479-i);
+        CHECK_EQ(events[i].touched, i != 9);
+    }
+}
+
+static void testStraySync()
+{
+    // a stray sync in front of a frame must not swallow it
+    bytes_t stream;
+    for (int f = 0; f < 3; f++) {
+        stream.push_back(TOUCH_FRAME_SYNC);
+        bytes_t b = frame(f*100, 3, false);
+        stream.insert(stream.end(), b.begin(), b.end());
+    }
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    dec.feed(&stream[0], stream.size());
+    CHECK_EQ(dec.framesOk, 3);
+    CHECK_EQ(events.size(), 9);
+}
+
+static void testCorruptFrame()
+{
+    bytes_t a = frame(0, 5, false);
+    bytes_t b = frame(50, 5, false);
+    a[6] ^= 0x10;
+    bytes_t stream = a;
+    stream.insert(stream.end(), b.begin(), b.end());
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    // byte by byte to exercise the buffering
+    for (size_t i = 0; i < stream.size(); i++)
+        dec.feed(&stream[i], 1);
+    CHECK_EQ(dec.framesOk, 1);
+    CHECK(dec.framesBad >= 1);
+    CHECK_EQ(events.size(), 5);
+    CHECK_EQ(events[0].timestamp, 50);
+}
+
+static void testSequenceGap()
+{
+    bytes_t out;
+    TouchTelemetry tel;
+    tel.setSink(collect, &out);
+    tel.setThresholds(1, 50);
+    std::vector<size_t> starts;
+    for (int i = 0; i < 6; i++) {
+        starts.push_back(out.size());
+        tel.addSample(i*5, i, i, true);
+    }
+    // drop the 3rd and 4th frame
+    bytes_t stream(out.begin(), out.begin()+starts[2]);
+    stream.insert(stream.end(), out.begin()+starts[4], out.end());
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    dec.feed(&stream[0], stream.size());
+    CHECK_EQ(dec.framesOk, 4);
+    CHECK_EQ(dec.framesLost, 2);
+}
+
+static void testNegativeX()
+{
+    bytes_t out;
+    TouchTelemetry tel;
+    tel.setSink(collect, &out);
+    tel.addSample(0, -6, 10, false);
+    tel.flush();
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    dec.feed(&out[0], out.size());
+    CHECK_EQ(events.size(), 1);
+    CHECK_EQ(events[0].x, 0);
+    CHECK_EQ(events[0].touched, false);
+}
+
+static void testHexOverCommunication()
+{
+    Communication com;
+    TouchTelemetry tel;
+    tel.setCommunication(&com);
+    tel.addSample(7, 1, 2, true);
+    tel.flush();
+    CHECK_EQ(com.sent.size(), 1);
+
+    const char *text = strchr(com.sent[0].c_str(), ':') + 1;
+    uint8_t buf[TOUCH_FRAME_MAX_BYTES];
+    uint16_t n = touchHexDecode(text, buf, sizeof(buf));
+    CHECK_EQ(n, strlen(text)/2);
+
+    std::vector<touchEvent_t> events;
+    TouchFrameDecoder dec(onEvent, &events);
+    dec.feed(buf, n);
+    CHECK_EQ(events.size(), 1);
+    CHECK_EQ(events[0].timestamp, 7);
+}
+
+int main()
+{
+    testRoundTrip();
+    testStraySync();
+    testCorruptFrame();
+    testSequenceGap();
+    testNegativeX();
+    testHexOverCommunication();
+    return hostResult("test_touchFrame");
+}
@@ -0,0 +1,169 @@
+/*
+ *  Tests of TouchRecorder, TouchReplay and TouchDecoder.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "touchRecorder.h"
+#include "touchDecoder.h"
+#include "hostTest.h"
+#include "hostTraces.h"
+
+static void collect(const touchRecord_t &record, void *ctx)
+{
+    ((std::vector<touchRecord_t>*)ctx)->push_back(record);
+}
+
+static void testRecordReplay()
+{
+    TouchRecorder rec;
+    uint8_t packet[AR1021_PACKET_SIZE] = { 0x81, 0x10, 0x20, 0x30, 0x1F };
+    uint8_t resp[2] = { 0x55, 0xAA };
+
+    rec.recordPacket(1, packet);
+    CHECK_EQ(rec.length(), 0);      // not started
+
+    rec.start();
+    rec.recordPacket(100, packet);
+    rec.recordCommand(105, 0x10, -1001, resp, sizeof(resp));
+    rec.stop();
+
+    std::vector<touchRecord_t> records;
+    TouchReplay replay(rec.data(), rec.length(), collect, &records);
+    replay.setSpeed(TOUCH_REPLAY_NO_DELAY);
+    CHECK_EQ(replay.poll(0), 2);
+    CHECK(replay.finished());
+    CHECK_EQ(records.size(), 2);
+    CHECK_EQ(records[0].type, TOUCH_REC_PACKET);
+    CHECK_EQ(records[0].timestamp, 100);
+    CHECK_EQ(records[0].len, AR1021_PACKET_SIZE);
+    CHECK(memcmp(records[0].payload, packet, AR1021_PACKET_SIZE) == 0);
+    CHECK_EQ(records[1].type, TOUCH_REC_CMD);
+    CHECK_EQ(records[1].timestamp, 105);
+    CHECK_EQ(records[1].len, 3 + sizeof(resp));
+    CHECK_EQ(records[1].payload[0], 0x10);
+    CHECK_EQ((int16_t)(records[1].payload[1] | (records[1].payload[2] << 8)), -1001);
+    CHECK_EQ(records[1].payload[4], 0xAA);
+}
+
+static void testFull()
+{
+    TouchRecorder rec;
+    uint8_t packet[AR1021_PACKET_SIZE] = { 0x80, 0, 0, 0, 0 };
+    int fits = TOUCH_RECORDER_SIZE / (TOUCH_REC_HDR_BYTES + AR1021_PACKET_SIZE);
+
+    rec.start();
+    for (int i = 0; i < fits + 3; i++)
+        rec.recordPacket(i, packet);
+    CHECK_EQ(rec.length(), fits * (TOUCH_REC_HDR_BYTES + AR1021_PACKET_SIZE));
+    CHECK_EQ(rec.dropped(), 3);
+}
+
+// shifts beyond the 16-bit timestamps are clamped, not undefined
+static void testSpeed()
+{
+    TouchRecorder rec;
+    uint8_t packet[AR1021_PACKET_SIZE] = { 0x80, 0, 0, 0, 0 };
+    rec.start();
+    rec.recordPacket(0, packet);
+    rec.recordPacket(40000, packet);
+
+    TouchReplay replay(rec.data(), rec.length(), NULL, NULL);
+    replay.setSpeed(20);
+    CHECK_EQ(replay.poll(0), 1);
+    CHECK_EQ(replay.poll(0), 0);
+    CHECK_EQ(replay.poll(1), 1);
+    CHECK(replay.finished());
+
+    replay.rewind();
+    replay.setSpeed(0);
+    CHECK_EQ(replay.poll(500), 1);
+    CHECK_EQ(replay.poll(500 + 39999), 0);
+    CHECK_EQ(replay.poll(500 + 40000), 1);
+}
+
+static void testDecodePen()
+{
+    TouchDecoder dec;
+    touchDecoded_t out;
+    uint8_t packet[AR1021_PACKET_SIZE] = { 0x81, 0, 0x10, 0, 0x08 };
+
+    dec.init(800, 480, false);
+    CHECK(dec.decode(packet, out));
+    CHECK(out.touched);
+    CHECK_EQ(out.x, 400);
+    CHECK_EQ(out.y, 120);
+    CHECK_EQ(out.rawX, 0x800);
+
+    packet[0] = 0x80;
+    CHECK(dec.decode(packet, out));
+    CHECK(!out.touched);
+
+    // bit 7 missing
+    packet[0] = 0x01;
+    CHECK(!dec.decode(packet, out));
+
+    // raw values are swapped before scaling on a rotated panel
+    dec.init(800, 480, true);
+    packet[0] = 0x81;
+    CHECK(dec.decode(packet, out));
+    CHECK_EQ(out.x, 200);
+    CHECK_EQ(out.y, 240);
+}
+
+// packets built from a trace decode to the trace again
+static void testDecodeTrace()
+{
+    trace_t trace = traceScribble(4);
+    TouchDecoder dec;
+    touchDecoded_t out;
+    uint8_t packet[AR1021_PACKET_SIZE];
+
+    dec.init(TRACE_WIDTH, TRACE_HEIGHT, false);
+    for (size_t i = 0; i < trace.size(); i++) {
+        traceToPacket(trace[i], TRACE_WIDTH, TRACE_HEIGHT, packet);
+        CHECK(dec.decode(packet, out));
+        CHECK_EQ(out.x, trace[i].x);
+        CHECK_EQ(out.y, trace[i].y);
+        CHECK_EQ(out.touched, trace[i].touched);
+        CHECK_EQ(out.xq >> AR1021_SUBPIXEL_BITS, out.x);
+    }
+}
+
+// negative offsets move the fixed-point coordinates by whole pixels
+static void testDecodeCorrected()
+{
+    TouchCorrection corr;
+    int8_t data[TOUCH_MESH_DATA_SIZE];
+    for (int i = 0; i < TOUCH_MESH_DATA_SIZE; i++)
+        data[i] = -5;
+    corr.init(TRACE_WIDTH, TRACE_HEIGHT);
+    corr.setData(data);
+
+    TouchDecoder dec;
+    touchDecoded_t plain, out;
+    uint8_t packet[AR1021_PACKET_SIZE];
+    traceSample_t s = { 0, 3, 300, true };
+    traceToPacket(s, TRACE_WIDTH, TRACE_HEIGHT, packet);
+
+    dec.init(TRACE_WIDTH, TRACE_HEIGHT, false);
+    CHECK(dec.decode(packet, plain));
+    dec.setCorrection(&corr);
+    CHECK(dec.decode(packet, out));
+    CHECK_EQ(out.x, 0);         // clamped to the panel
+    CHECK_EQ(out.y, 295);
+    CHECK_EQ(out.xq >> AR1021_SUBPIXEL_BITS, out.x);
+    CHECK_EQ(out.yq, plain.yq - 5*(1<<AR1021_SUBPIXEL_BITS));
+}
+
+int main()
+{
+    testRecordReplay();
+    testFull();
+    testSpeed();
+    testDecodePen();
+    testDecodeTrace();
+    testDecodeCorrected();
+    return hostResult("test_touchRecorder");
+}
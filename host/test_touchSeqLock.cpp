@@ -0,0 +1,99 @@
+/*
+ *  Stress test of TouchSeqLock: one writer thread stands in for the touch
+ *  interrupt, several reader threads check that every copy they accept is
+ *  consistent.
+ *
+ *  The counter is 32 bits wide here since a reader thread can be preempted
+ *  for longer than 128 writes, unlike the main context on the AVR.
+ */
+
+#include <pthread.h>
+
+#include "touchSeqLock.h"
+#include "hostTest.h"
+
+#define STRESS_WRITES  (500000)
+#define STRESS_READERS (3)
+
+typedef struct
+{
+    volatile uint32_t a;
+    volatile uint32_t b;
+    volatile uint32_t c;
+} shared_t;
+
+static TouchSeqLock<uint32_t> lock;
+static shared_t shared;
+static volatile bool done;
+
+typedef struct
+{
+    uint32_t copies;
+    uint32_t torn;
+    uint32_t retries;
+} readerStats_t;
+
+static void *writer(void *)
+{
+    for (uint32_t i = 1; i <= STRESS_WRITES; i++) {
+        lock.writeBegin();
+        shared.a = i;
+        shared.b = ~i;
+        shared.c = i * 2654435761u;
+        lock.writeEnd();
+    }
+    done = true;
+    return NULL;
+}
+
+static void *reader(void *ctx)
+{
+    readerStats_t *stats = (readerStats_t*)ctx;
+
+    while (!done) {
+        uint32_t seq, a, b, c;
+        if (!lock.readBegin(seq)) {
+            stats->retries++;
+            continue;
+        }
+        a = shared.a;
+        b = shared.b;
+        c = shared.c;
+        if (lock.readRetry(seq)) {
+            stats->retries++;
+            continue;
+        }
+        stats->copies++;
+        if (b != ~a || c != a * 2654435761u)
+            stats->torn++;
+    }
+    return NULL;
+}
+
+int main()
+{
+    pthread_t w, r[STRESS_READERS];
+    readerStats_t stats[STRESS_READERS] = {};
+
+    shared.a = 0;
+    shared.b = ~0u;
+    shared.c = 0;
+
+    for (int i = 0; i < STRESS_READERS; i++)
+        pthread_create(&r[i], NULL, reader, &stats[i]);
+    pthread_create(&w, NULL, writer, NULL);
+    pthread_join(w, NULL);
+
+    uint32_t copies = 0, retries = 0;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        pthread_join(r[i], NULL);
+        CHECK_EQ(stats[i].torn, 0);
+        copies += stats[i].copies;
+        retries += stats[i].retries;
+    }
+    CHECK(copies > 0);
+    CHECK_EQ(lock.sequence(), 2u * STRESS_WRITES);
+    printf("  %u consistent copies, %u retries\n", copies, retries);
+
+    return hostResult("test_touchSeqLock");
+}
@@ -0,0 +1,133 @@
+/*
+ *  Replay a recording of the AR1021 traffic dumped by
+ *  AR1021::dumpRecording() through the driver.
+ *
+ *  usage: touchReplay [-w width] [-h height] [-R] [-c dist,interval,latency]
+ *                     [-r shift] [file]
+ *
+ *  Reads the hex lines of the dump (any other text on a line is skipped)
+ *  from file or stdin. The driver is initialized for a panel of width x
+ *  height (default 800x480, -R for a rotated panel), with the recorded
+ *  responses if the recording starts with init(). Every touch packet is
+ *  then clocked in over the simulated SPI bus and the events returned by
+ *  AR1021::read() are printed as "t x y touched", the format read by the
+ *  benchmarks. -c sets the coalescing of read(). Without -r the packets
+ *  are replayed at once, with -r at their original pace accelerated by
+ *  2^shift.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "driverReplay.h"
+#include "hostAr1021.h"
+
+static bool isHex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t width = 800, height = 480;
+    bool rotated = false;
+    int speed = -1;
+    unsigned minDistance = 0, minInterval = 0, maxLatency = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:h:Rc:r:")) != -1) {
+        switch (opt) {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 'R':
+            rotated = true;
+            break;
+        case 'c':
+            sscanf(optarg, "%u,%u,%u", &minDistance, &minInterval, &maxLatency);
+            break;
+        case 'r':
+            speed = atoi(optarg);
+            if (speed > TOUCH_REPLAY_MAX_SHIFT) speed = TOUCH_REPLAY_MAX_SHIFT;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-w width] [-h height] [-R] [-c dist,interval,latency] "
+                    "[-r shift] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *in = stdin;
+    if (optind < argc) {
+        in = fopen(argv[optind], "r");
+        if (in == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    // the dump splits the recording into lines, records cross them
+    std::vector<uint8_t> data;
+    char line[1024];
+    uint8_t buf[sizeof(line)/2];
+    while (fgets(line, sizeof(line), in) != NULL) {
+        for (char *p = line; *p; ) {
+            if (!isHex(*p)) {
+                p++;
+                continue;
+            }
+            size_t run = 0;
+            while (isHex(p[run])) run++;
+            // skip words of the surrounding text
+            if (run >= 2*TOUCH_REC_HDR_BYTES && (run & 1) == 0) {
+                uint16_t n = touchHexDecode(p, buf, run/2);
+                data.insert(data.end(), buf, buf+n);
+            }
+            p += run;
+        }
+    }
+    if (in != stdin) fclose(in);
+
+    if (data.empty() || data.size() > 0xFFFF) {
+        fprintf(stderr, "no recording found\n");
+        return 1;
+    }
+
+    static volatile TIMER timeout;
+    AR1021 driver(&timeout, SPI_INTLVL_LO_gc, false, SPI_PRESCALER_DIV64_gc);
+    hostAr1021.attachTimer(&timeout);
+
+    DriverReplay replay(driver, &data[0], data.size());
+    replay.setAnswerFromRecording(replay.recordedInit());
+    if (!driver.init(width, height, rotated)) {
+        fprintf(stderr, "init failed\n");
+        return 1;
+    }
+    replay.setAnswerFromRecording(true);
+    driver.setCoalescing(minDistance, minInterval, maxLatency);
+
+    uint16_t t, last = 0;
+    bool started = false;
+    AR1021::touchCoordinate_t coord;
+    while (replay.next(t)) {
+        if (speed >= 0 && started) {
+            fflush(stdout);
+            usleep((useconds_t)((uint16_t)(t - last) >> speed) * 1000);
+        }
+        started = true;
+        last = t;
+        if (driver.read(coord))
+            printf("%u %d %d %d\n", t, coord.x, coord.y, coord.touched ? 1 : 0);
+    }
+
+    fprintf(stderr, "packets %u, commands %u replayed, %u missing, %u mismatched, "
+            "%u suppressed\n", replay.packets, replay.commandsReplayed,
+            replay.commandsMissing, replay.commandsMismatched, driver.suppressedEvents());
+    return 0;
+}
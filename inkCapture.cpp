@@ -0,0 +1,246 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "inkCapture.h"
+
+
+void InkCapture::setTolerance(uint8_t radial, uint8_t deviation)
+{
+  // a radial tolerance of 0 would allow identical points which collide
+  // with the end-of-stroke marker
+  _radial = (radial == 0) ? 1 : radial;
+  _deviation = deviation;
+}
+
+void InkCapture::reset()
+{
+  _inStroke = false;
+  _strokeOpen = false;
+  _hasPending = false;
+  _anchorX = _anchorY = 0;
+  _pendingX = _pendingY = 0;
+  _lastX = _lastY = 0;
+  _windowCount = 0;
+  _head = _tail = _count = 0;
+  pointsIn = pointsOut = pointsLost = 0;
+}
+
+void InkCapture::addSample(int16_t x, int16_t y, bool touched)
+{
+  // pen down -> start a new stroke
+  if (!_inStroke) {
+    if (!touched) return;
+    pointsIn++;
+    _inStroke = true;
+    _hasPending = false;
+    _windowCount = 0;
+    _anchorX = x;
+    _anchorY = y;
+    emitPoint(x, y);
+    return;
+  }
+
+  // pen up -> write the last candidate and close the stroke
+  if (!touched) {
+    if (_hasPending)
+      emitPoint(_pendingX, _pendingY);
+    emitEnd();
+    _inStroke = false;
+    _hasPending = false;
+    return;
+  }
+
+  pointsIn++;
+
+  // radial distance to the last kept point
+  int16_t refX = _hasPending ? _pendingX : _anchorX;
+  int16_t refY = _hasPending ? _pendingY : _anchorY;
+  int32_t rx = (int32_t)x - refX;
+  int32_t ry = (int32_t)y - refY;
+  if (rx*rx + ry*ry < (int32_t)_radial*_radial)
+    return;
+
+  if (!_hasPending) {
+    _pendingX = x;
+    _pendingY = y;
+    _hasPending = true;
+    return;
+  }
+
+  // drop the candidate if it and the window still fit the new segment
+  bool drop = (_windowCount < INK_WINDOW_SIZE) && fits(_pendingX, _pendingY, x, y);
+  for (uint8_t i = 0; drop && i < _windowCount; i++)
+    drop = fits(_windowX[i], _windowY[i], x, y);
+
+  if (drop) {
+    _windowX[_windowCount] = _pendingX;
+    _windowY[_windowCount] = _pendingY;
+    _windowCount++;
+  }
+  else {
+    emitPoint(_pendingX, _pendingY);
+    _anchorX = _pendingX;
+    _anchorY = _pendingY;
+    _windowCount = 0;
+  }
+  _pendingX = x;
+  _pendingY = y;
+}
+
+/**
+ * Check if point p is within the deviation tolerance of the segment from
+ * the anchor to (x,y). The Euclidean length of the segment is bounded from
+ * below by L1 * 181/256 (~1/sqrt(2)) so the check stays in 32-bit integers
+ * and never accepts a point farther away than the tolerance.
+ */
+bool InkCapture::fits(int16_t px, int16_t py, int16_t x, int16_t y) const
+{
+  int32_t dx = (int32_t)x - _anchorX;
+  int32_t dy = (int32_t)y - _anchorY;
+  int32_t qx = (int32_t)px - _anchorX;
+  int32_t qy = (int32_t)py - _anchorY;
+
+  // degenerate segment, distance to the anchor
+  if (dx == 0 && dy == 0) {
+    int32_t l1 = (qx < 0 ? -qx : qx) + (qy < 0 ? -qy : qy);
+    return l1 <= _deviation;
+  }
+
+  // the projection must fall onto the segment, otherwise a turning point
+  // (e.g. of a back-and-forth stroke) would be lost
+  int32_t dot = qx*dx + qy*dy;
+  if (dot < 0 || dot > dx*dx + dy*dy) return false;
+
+  int32_t cross = dx*qy - dy*qx;
+  if (cross < 0) cross = -cross;
+  int32_t l1 = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+  return cross <= (((int32_t)_deviation * l1 * 181) >> 8);
+}
+
+uint8_t InkCapture::available()
+{
+  return _count;
+}
+
+uint8_t InkCapture::readBytes(uint8_t *buf, uint8_t maxLen)
+{
+  uint8_t n = 0;
+  while (n < maxLen && _count > 0) {
+    buf[n++] = _buf[_tail];
+    _tail = (_tail + 1) % INK_BUFFER_SIZE;
+    _count--;
+  }
+  return n;
+}
+
+void InkCapture::emitPoint(int16_t x, int16_t y)
+{
+  // a zero delta inside a stroke is the end marker
+  if (_strokeOpen && x == _lastX && y == _lastY)
+    return;
+
+  // always keep room for the end marker of the current stroke
+  if (INK_BUFFER_SIZE - _count < INK_MAX_POINT_BYTES + INK_END_BYTES) {
+    pointsLost++;
+    return;
+  }
+  putVarint(x - _lastX);
+  putVarint(y - _lastY);
+  _lastX = x;
+  _lastY = y;
+  _strokeOpen = true;
+  pointsOut++;
+}
+
+void InkCapture::emitEnd()
+{
+  // a stroke without any written point must not be closed
+  if (!_strokeOpen) return;
+  put(0);
+  put(0);
+  _strokeOpen = false;
+}
+
+void InkCapture::putVarint(int16_t value)
+{
+  // zigzag: small negative and positive values get small codes
+  uint16_t v = ((uint16_t)value << 1) ^ (uint16_t)(value >> 15);
+  while (v >= 0x80) {
+    put((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  put(v);
+}
+
+void InkCapture::put(uint8_t b)
+{
+  if (_count >= INK_BUFFER_SIZE) return;
+  _buf[_head] = b;
+  _head = (_head + 1) % INK_BUFFER_SIZE;
+  _count++;
+}
+
+
+void InkDecoder::reset()
+{
+  _inStroke = false;
+  _haveDx = false;
+  _dx = 0;
+  _acc = 0;
+  _shift = 0;
+  _x = _y = 0;
+  errors = 0;
+}
+
+// drop the varint and the pair it belongs to, close an open stroke
+void InkDecoder::resync()
+{
+  errors++;
+  _acc = 0;
+  _shift = 0;
+  _haveDx = false;
+  if (_inStroke) {
+    _inStroke = false;
+    if (_onStrokeEnd != NULL) _onStrokeEnd(_ctx);
+  }
+}
+
+void InkDecoder::feed(const uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    // the last byte of a varint may only carry the top 2 bits
+    if (_shift == 7*(INK_MAX_VARINT_BYTES-1) && (data[i] & ~0x03)) {
+      resync();
+      continue;
+    }
+    _acc |= (uint16_t)(data[i] & 0x7f) << _shift;
+    if (data[i] & 0x80) {
+      _shift += 7;
+      continue;
+    }
+
+    int16_t value = (int16_t)((_acc >> 1) ^ (uint16_t)(-(int16_t)(_acc & 1)));
+    _acc = 0;
+    _shift = 0;
+
+    if (!_haveDx) {
+      _dx = value;
+      _haveDx = true;
+      continue;
+    }
+    _haveDx = false;
+
+    if (_inStroke && _dx == 0 && value == 0) {
+      _inStroke = false;
+      if (_onStrokeEnd != NULL) _onStrokeEnd(_ctx);
+      continue;
+    }
+
+    _x += _dx;
+    _y += value;
+    bool start = !_inStroke;
+    _inStroke = true;
+    if (_onPoint != NULL) _onPoint(_x, _y, start, _ctx);
+  }
+}
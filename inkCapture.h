@@ -0,0 +1,161 @@
+/*
+ *  Ink capture for the AR1021 touch controller.
+ *
+ *  Groups touch samples between pen-down and pen-up into strokes,
+ *  simplifies them incrementally and encodes them into a compact
+ *  binary stream.
+ *
+ *  Stream format
+ *  -------------
+ *  Every point is written as two zigzag varints (dx, dy) relative to the
+ *  previously written point (the very first point is relative to 0/0).
+ *  The first pair after the start of the stream or after an end marker is
+ *  the first point of a stroke. Inside a stroke the pair (0,0) marks the
+ *  end of the stroke; it can not occur as a real point since identical
+ *  successive points are always dropped. Empty strokes are never written.
+ */
+
+#ifndef INKCAPTURE_H
+#define INKCAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+// size of the output buffer in bytes (max. 255)
+#ifndef INK_BUFFER_SIZE
+#define INK_BUFFER_SIZE (128)
+#endif
+
+// a zigzagged int16 needs at most 3 varint bytes, a point 2 varints
+#define INK_MAX_VARINT_BYTES (3)
+#define INK_MAX_POINT_BYTES  (2*INK_MAX_VARINT_BYTES)
+#define INK_END_BYTES       (2)
+
+// number of dropped points which are re-checked against the current
+// segment; a point is written at the latest when the window is full
+#ifndef INK_WINDOW_SIZE
+#define INK_WINDOW_SIZE (8)
+#endif
+
+#define INK_DEFAULT_RADIAL    (2)
+#define INK_DEFAULT_DEVIATION (1)
+
+
+/**
+ * Collects touch samples, simplifies strokes and writes the encoded
+ * strokes into an internal buffer which is drained with readBytes().
+ *
+ * Simplification uses bounded memory: samples closer than the radial
+ * tolerance to the last candidate are dropped. A candidate is dropped as
+ * well if it and all points dropped since the last written point lie
+ * within the deviation tolerance of the segment from the last written
+ * point to the newest sample. Every input sample therefore stays within
+ * radial + deviation of the written polyline.
+ */
+class InkCapture
+{
+public:
+
+    InkCapture()
+    {
+      _radial = INK_DEFAULT_RADIAL;
+      _deviation = INK_DEFAULT_DEVIATION;
+      reset();
+    }
+
+    void setTolerance(uint8_t radial, uint8_t deviation);
+    void reset();
+
+    void addSample(int16_t x, int16_t y, bool touched);
+
+    uint8_t available();
+    uint8_t readBytes(uint8_t *buf, uint8_t maxLen);
+
+    uint16_t pointsIn;      // samples received inside strokes
+    uint16_t pointsOut;     // points written to the stream
+    uint16_t pointsLost;    // points dropped because the buffer was full
+
+private:
+
+    uint8_t _radial;
+    uint8_t _deviation;
+
+    bool    _inStroke;
+    bool    _strokeOpen;            // a point of this stroke was written
+    bool    _hasPending;
+    int16_t _anchorX, _anchorY;     // last point written in this stroke
+    int16_t _pendingX, _pendingY;   // candidate which is not written yet
+    int16_t _lastX, _lastY;         // reference for the delta encoding
+
+    // points dropped since the anchor, still checked against the segment
+    int16_t _windowX[INK_WINDOW_SIZE];
+    int16_t _windowY[INK_WINDOW_SIZE];
+    uint8_t _windowCount;
+
+    uint8_t _buf[INK_BUFFER_SIZE];
+    uint8_t _head;
+    uint8_t _tail;
+    uint8_t _count;
+
+    bool fits(int16_t px, int16_t py, int16_t x, int16_t y) const;
+    void emitPoint(int16_t x, int16_t y);
+    void emitEnd();
+    void putVarint(int16_t value);
+    void put(uint8_t b);
+};
+
+
+/**
+ * Decodes the stream written by InkCapture. Bytes may be fed in chunks of
+ * any size.
+ *
+ * A varint longer than INK_MAX_VARINT_BYTES or with more than 16 bits is
+ * counted in errors and dropped together with a pending dx, and an open
+ * stroke is closed. The next byte starts the dx of a new stroke. Since
+ * the points are deltas, the positions after an error keep the offset of
+ * the lost deltas; a link which loses bytes should carry the stream in
+ * checked frames and reset() the decoder after a bad one.
+ */
+class InkDecoder
+{
+public:
+
+    typedef void (*pointCallback_t)(int16_t x, int16_t y, bool strokeStart, void *ctx);
+    typedef void (*strokeEndCallback_t)(void *ctx);
+
+    InkDecoder(pointCallback_t onPoint, strokeEndCallback_t onStrokeEnd, void *ctx)
+    {
+      _onPoint = onPoint;
+      _onStrokeEnd = onStrokeEnd;
+      _ctx = ctx;
+      reset();
+    }
+
+    void reset();
+    void feed(const uint8_t *data, size_t len);
+
+    uint16_t errors;
+
+private:
+
+    pointCallback_t     _onPoint;
+    strokeEndCallback_t _onStrokeEnd;
+    void               *_ctx;
+
+    bool     _inStroke;
+    bool     _haveDx;
+    int16_t  _dx;
+    uint16_t _acc;
+    uint8_t  _shift;
+    int16_t  _x, _y;
+
+    void resync();
+};
+
+#endif
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchCoalescer.h"
+
+
+/**
+ * Change the settings, also at runtime. 0 disables the respective check.
+ *
+ * @param minDistance moves shorter than this (x plus y distance in pixels
+ * to the last reported position) are not reported
+ * @param minInterval minimum time between two reported moves
+ * @param maxLatency a pending move is reported once this time has passed
+ * since the last report, even if it is shorter than minDistance. Should
+ * be larger than minInterval.
+ */
+void TouchCoalescer::configure(uint8_t minDistance, uint16_t minInterval, uint16_t maxLatency)
+{
+  _minDistance = minDistance;
+  _minInterval = minInterval;
+  _maxLatency = maxLatency;
+}
+
+void TouchCoalescer::reset()
+{
+  _lastX = _lastY = 0;
+  _lastTouched = false;
+  _lastReport = 0;
+  _haveSuppressed = false;
+  _suppressedSeq = 0;
+  suppressed = 0;
+}
+
+/**
+ * Decide whether a changed sample is reported. A reported sample becomes
+ * the reference for the following ones.
+ *
+ * @param seq sequence value of the sample, a sample which is offered
+ * several times is only counted once when suppressed
+ * @param now current time
+ * @param timed false if there is no time base; minInterval and maxLatency
+ * are ignored then, since a time which never advances would suppress
+ * moves forever
+ *
+ * @return true if the sample is reported
+ */
+bool TouchCoalescer::accept(int16_t x, int16_t y, bool touched, uint8_t seq, uint16_t now, bool timed)
+{
+  if (touched == _lastTouched) {
+    int16_t dx = x - _lastX;
+    int16_t dy = y - _lastY;
+    uint16_t distance = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+    uint16_t elapsed = now - _lastReport;
+
+    bool due = timed && (_maxLatency > 0) && (elapsed >= _maxLatency);
+    bool early = timed && (elapsed < _minInterval);
+    if (!due && ((distance < _minDistance) || early)) {
+      if (!_haveSuppressed || seq != _suppressedSeq) {
+        suppressed++;
+        _suppressedSeq = seq;
+        _haveSuppressed = true;
+      }
+      return false;
+    }
+  }
+
+  _lastX = x;
+  _lastY = y;
+  _lastTouched = touched;
+  _lastReport = now;
+  return true;
+}
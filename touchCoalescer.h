@@ -0,0 +1,52 @@
+/*
+ *  Coalescing of touch moves.
+ *
+ *  A finger resting on the panel produces a stream of one-pixel changes.
+ *  TouchCoalescer drops moves which are shorter than a minimum distance
+ *  or come sooner than a minimum interval after the last reported one,
+ *  but reports a pending move once a maximum latency has passed. Pen down
+ *  and pen up always pass.
+ */
+
+#ifndef TOUCHCOALESCER_H
+#define TOUCHCOALESCER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+class TouchCoalescer
+{
+public:
+
+    TouchCoalescer()
+    {
+      _minDistance = 0;
+      _minInterval = 0;
+      _maxLatency = 0;
+      reset();
+    }
+
+    void configure(uint8_t minDistance, uint16_t minInterval, uint16_t maxLatency);
+    void reset();
+
+    bool accept(int16_t x, int16_t y, bool touched, uint8_t seq, uint16_t now, bool timed);
+
+    // moves dropped by accept(), every sequence value is counted once
+    uint16_t suppressed;
+
+private:
+
+    uint8_t  _minDistance;
+    uint16_t _minInterval;
+    uint16_t _maxLatency;
+
+    int16_t  _lastX;
+    int16_t  _lastY;
+    bool     _lastTouched;
+    uint16_t _lastReport;
+    bool     _haveSuppressed;
+    uint8_t  _suppressedSeq;
+};
+
+#endif
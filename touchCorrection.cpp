@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchCorrection.h"
+#include "touchSeqLock.h"
+
+
+void TouchCorrection::init(uint16_t width, uint16_t height, uint8_t inset)
+{
+  // apply() may run in the touch interrupt, stop it before the mesh changes
+  _valid = false;
+  TOUCH_SEQ_BARRIER();
+
+  int xInset = ((uint32_t)width * inset / 100) / 2;
+  int yInset = ((uint32_t)height * inset / 100) / 2;
+
+  _width = width;
+  _height = height;
+  _x0 = xInset;
+  _y0 = yInset;
+  _stepX = (width - 2*xInset) / (TOUCH_MESH_SIZE-1);
+  _stepY = (height - 2*yInset) / (TOUCH_MESH_SIZE-1);
+  if (_stepX == 0) _stepX = 1;
+  if (_stepY == 0) _stepY = 1;
+  _invX = (1UL << 16) / _stepX;
+  _invY = (1UL << 16) / _stepY;
+
+  for (uint8_t i = 0; i < TOUCH_MESH_DATA_SIZE; i++)
+    _offset[i] = 0;
+  _calibPoint = TOUCH_MESH_POINTS;
+}
+
+bool TouchCorrection::calibrateStart()
+{
+  if (_stepX == 0) return false;
+
+  // measurements during calibration must be uncorrected
+  _valid = false;
+  TOUCH_SEQ_BARRIER();
+  _calibPoint = 0;
+  return true;
+}
+
+bool TouchCorrection::getNextCalibratePoint(uint16_t* x, uint16_t* y)
+{
+  if (x == NULL || y == NULL) return false;
+  if (_calibPoint >= TOUCH_MESH_POINTS) return false;
+
+  *x = _x0 + (_calibPoint % TOUCH_MESH_SIZE) * _stepX;
+  *y = _y0 + (_calibPoint / TOUCH_MESH_SIZE) * _stepY;
+  return true;
+}
+
+/**
+ * Record the measured position for the point returned by the last call
+ * to getNextCalibratePoint().
+ *
+ * @param x uncorrected x coordinate of the touch
+ * @param y uncorrected y coordinate of the touch
+ * @param morePoints true is written to this argument if there are more
+ * calibration points; otherwise it will be false
+ *
+ * @return true if the request was successful; otherwise false
+ */
+bool TouchCorrection::addCalibratePoint(int16_t x, int16_t y, bool* morePoints)
+{
+  uint16_t tx, ty;
+
+  if (morePoints == NULL) return false;
+  if (!getNextCalibratePoint(&tx, &ty)) return false;
+
+  int16_t dx = (int16_t)tx - x;
+  int16_t dy = (int16_t)ty - y;
+  if (dx > 127) dx = 127;
+  if (dx < -128) dx = -128;
+  if (dy > 127) dy = 127;
+  if (dy < -128) dy = -128;
+
+  _offset[2*_calibPoint]   = dx;
+  _offset[2*_calibPoint+1] = dy;
+
+  _calibPoint++;
+  *morePoints = (_calibPoint < TOUCH_MESH_POINTS);
+  if (!(*morePoints)) {
+    TOUCH_SEQ_BARRIER();
+    _valid = true;
+  }
+
+  return true;
+}
+
+void TouchCorrection::setData(const int8_t *data)
+{
+  if (data == NULL) return;
+  _valid = false;
+  TOUCH_SEQ_BARRIER();
+  for (uint8_t i = 0; i < TOUCH_MESH_DATA_SIZE; i++)
+    _offset[i] = data[i];
+  _calibPoint = TOUCH_MESH_POINTS;
+  // only a complete mesh is applied
+  TOUCH_SEQ_BARRIER();
+  _valid = true;
+}
+
+/**
+ * Find the mesh cell of a coordinate and the position inside the cell
+ * (0..256). Outside the mesh the offsets of the outer points are used.
+ */
+void TouchCorrection::locate(int16_t v, int16_t v0, uint32_t inv, uint8_t &cell, uint16_t &frac) const
+{
+  if (v <= v0) {
+    cell = 0;
+    frac = 0;
+    return;
+  }
+
+  uint32_t u = ((uint32_t)(v - v0) * inv) >> 8;   // Q8
+  if (u >= ((uint32_t)(TOUCH_MESH_SIZE-1) << 8)) {
+    cell = TOUCH_MESH_SIZE-2;
+    frac = 256;
+    return;
+  }
+  cell = u >> 8;
+  frac = u & 0xFF;
+}
+
+/**
+ * Correct a coordinate in place. The result is clamped to the panel, an
+ * offset at the edge must not move a touch outside of it.
+ */
+void TouchCorrection::apply(int16_t &x, int16_t &y) const
+{
+  if (!_valid) return;
+
+  uint8_t cx, cy;
+  uint16_t fx, fy;
+  locate(x, _x0, _invX, cx, fx);
+  locate(y, _y0, _invY, cy, fy);
+
+  const int8_t *p00 = &_offset[2*(cy*TOUCH_MESH_SIZE + cx)];
+  const int8_t *p01 = p00 + 2;
+  const int8_t *p10 = p00 + 2*TOUCH_MESH_SIZE;
+  const int8_t *p11 = p10 + 2;
+
+  for (uint8_t axis = 0; axis < 2; axis++) {
+    // interpolate along x (Q8), then along y (Q16)
+    int16_t top    = p00[axis]*(int16_t)(256-fx) + p01[axis]*(int16_t)fx;
+    int16_t bottom = p10[axis]*(int16_t)(256-fx) + p11[axis]*(int16_t)fx;
+    int32_t v = (int32_t)top*(256-fy) + (int32_t)bottom*fy;
+    int16_t offset = (v + (1L << 15)) >> 16;
+    if (axis == 0)
+      x += offset;
+    else
+      y += offset;
+  }
+
+  if (x < 0) x = 0;
+  if (x >= (int16_t)_width) x = _width-1;
+  if (y < 0) y = 0;
+  if (y >= (int16_t)_height) y = _height-1;
+}
@@ -0,0 +1,86 @@
+/*
+ *  Correction of panel nonlinearity with a calibration mesh.
+ *
+ *  A grid of TOUCH_MESH_SIZE x TOUCH_MESH_SIZE reference points covers
+ *  the panel. For every point the difference between target and measured
+ *  position is stored as a signed byte per axis. A sample is corrected by
+ *  bilinear interpolation of the offsets of the four surrounding points,
+ *  in fixed-point arithmetic without divisions.
+ */
+
+#ifndef TOUCHCORRECTION_H
+#define TOUCHCORRECTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#ifndef TOUCH_MESH_SIZE
+#define TOUCH_MESH_SIZE (5)
+#endif
+
+#define TOUCH_MESH_POINTS    (TOUCH_MESH_SIZE*TOUCH_MESH_SIZE)
+// offsets of x and y for every point
+#define TOUCH_MESH_DATA_SIZE (2*TOUCH_MESH_POINTS)
+
+// default inset of the outer points, 10 -> (10/2 = 5%)
+#define TOUCH_MESH_DEFAULT_INSET (10)
+
+
+/**
+ * Usage: init() with the panel size, then either setData() with stored
+ * offsets or run the calibration: calibrateStart(), then for every point
+ * getNextCalibratePoint(), draw the target and pass the uncorrected
+ * touch position to addCalibratePoint(). The correction is active once
+ * all points were recorded. Corrected coordinates stay within the panel.
+ *
+ * apply() may run in the touch interrupt while init(), setData() or the
+ * calibration run in the main loop: the correction is disabled before
+ * the mesh is changed and enabled only once it is complete.
+ */
+class TouchCorrection
+{
+public:
+
+    TouchCorrection()
+    {
+      _valid = false;
+      _calibPoint = TOUCH_MESH_POINTS;
+      _stepX = _stepY = 0;
+      _width = _height = 0;
+    }
+
+    void init(uint16_t width, uint16_t height, uint8_t inset=TOUCH_MESH_DEFAULT_INSET);
+
+    bool calibrateStart();
+    bool getNextCalibratePoint(uint16_t* x, uint16_t* y);
+    bool addCalibratePoint(int16_t x, int16_t y, bool* morePoints);
+
+    const int8_t *getData() const { return _offset; }
+    void setData(const int8_t *data);
+    bool isValid() const { return _valid; }
+
+    void apply(int16_t &x, int16_t &y) const;
+
+private:
+
+    volatile bool _valid;
+    uint8_t _calibPoint;
+
+    uint16_t _width, _height;
+    int16_t  _x0, _y0;        // position of the first point
+    uint16_t _stepX, _stepY;  // distance between points
+    uint32_t _invX, _invY;    // 1/step in Q16
+
+    // x and y offset of every point, row by row
+    int8_t _offset[TOUCH_MESH_DATA_SIZE];
+
+    void locate(int16_t v, int16_t v0, uint32_t inv, uint8_t &cell, uint16_t &frac) const;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchDecoder.h"
+
+
+void TouchDecoder::init(uint16_t width, uint16_t height, bool rotated)
+{
+  _width = width;
+  _height = height;
+  _rotated = rotated;
+}
+
+/**
+ * Correct every decoded packet with the mesh. The mesh only changes the
+ * coordinates once it is valid, so measurements for its calibration are
+ * taken uncorrected.
+ */
+void TouchDecoder::setCorrection(TouchCorrection *correction)
+{
+  _correction = correction;
+}
+
+/**
+ * Decode a touch packet.
+ *
+ * @param packet the AR1021_PACKET_SIZE bytes of the packet
+ * @param out the decoded coordinates
+ *
+ * @return true if the packet was valid; otherwise false
+ */
+bool TouchDecoder::decode(const uint8_t *packet, touchDecoded_t &out) const
+{
+    uint8_t pen = packet[0];
+    uint16_t rawX = ((uint16_t)packet[2]<<7)|packet[1];
+    uint16_t rawY = ((uint16_t)packet[4]<<7)|packet[3];
+
+    // pen down
+    if ((pen&AR1021_PEN_MASK) == (1<<7|1<<0)) {
+        out.touched = true;
+    }
+    // pen up
+    else if ((pen&AR1021_PEN_MASK) == (1<<7)){
+        out.touched = false;
+    }
+    // invalid value
+    else {
+        return false;
+    }
+
+    if(_rotated)
+    {
+      uint16_t tmp = rawX;
+      rawX = rawY;
+      rawY = tmp;
+    }
+
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+    // scale to fixed-point pixels, the integer pixel is the upper part
+    out.rawX = rawX;
+    out.rawY = rawY;
+    out.xq = ( (uint32_t)rawX * _width )>>(12-AR1021_SUBPIXEL_BITS);
+    out.yq = ( (uint32_t)rawY * _height )>>(12-AR1021_SUBPIXEL_BITS);
+    out.x = out.xq>>AR1021_SUBPIXEL_BITS;
+    out.y = out.yq>>AR1021_SUBPIXEL_BITS;
+    if (_correction != NULL) {
+        int16_t x = out.x;
+        int16_t y = out.y;
+        _correction->apply(out.x, out.y);
+        // the offset may be negative, multiply instead of shifting
+        out.xq += (out.x - x) * (1<<AR1021_SUBPIXEL_BITS);
+        out.yq += (out.y - y) * (1<<AR1021_SUBPIXEL_BITS);
+    }
+#else
+    // legacy scaling with a 16-bit product, as on the AVR target where
+    // int is 16 bits wide; the host reproduces the target results
+    out.x = (uint16_t)(rawX * _width) >> 12;
+    out.y = (uint16_t)(rawY * _height) >> 12;
+    if (_correction != NULL)
+        _correction->apply(out.x, out.y);
+#endif
+
+    return true;
+}
@@ -0,0 +1,95 @@
+/*
+ *  Decoding of AR1021 touch packets into panel coordinates.
+ *
+ *  The driver decodes every packet read over SPI with it.
+ */
+
+#ifndef TOUCHDECODER_H
+#define TOUCHDECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "touchCorrection.h"
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+// bit 7 is always 1 and bit 0 defines pen up or down
+#define AR1021_PEN_MASK (0x81)
+
+// size of a touch data packet
+#define AR1021_PACKET_SIZE (5)
+
+// output formats, select one with AR1021_OUTPUT_FORMAT at compile time
+// PIXEL:    only integer pixel coordinates (touchCoordinate_t)
+// EXTENDED: additionally raw 12-bit and fixed-point pixel coordinates
+//           (touchSample_t), available through readSample(). The scaling
+//           is done in 32 bits, so actual can differ from PIXEL where the
+//           16-bit product raw*width of the legacy scaling overflows.
+#define AR1021_FORMAT_PIXEL    (0)
+#define AR1021_FORMAT_EXTENDED (1)
+
+#ifndef AR1021_OUTPUT_FORMAT
+#define AR1021_OUTPUT_FORMAT AR1021_FORMAT_PIXEL
+#endif
+
+// number of fractional bits of the fixed-point coordinates in touchSample_t
+// (4 -> 1/16 pixel). x/y of touchSample_t are 16 bit, so the panel may be
+// at most (65535 >> AR1021_SUBPIXEL_BITS) pixels wide/high, i.e. 4095
+// pixels with 4 bits.
+#ifndef AR1021_SUBPIXEL_BITS
+#define AR1021_SUBPIXEL_BITS (4)
+#endif
+
+#if (AR1021_SUBPIXEL_BITS < 0) || (AR1021_SUBPIXEL_BITS > 4)
+#error "AR1021_SUBPIXEL_BITS must be in the range 0..4"
+#endif
+
+typedef struct
+{
+    int16_t  x;
+    int16_t  y;
+    bool     touched;
+#if AR1021_OUTPUT_FORMAT == AR1021_FORMAT_EXTENDED
+    uint16_t rawX;
+    uint16_t rawY;
+    uint16_t xq;        // x with AR1021_SUBPIXEL_BITS fraction bits
+    uint16_t yq;
+#endif
+} touchDecoded_t;
+
+
+/**
+ * Converts the 5-byte packets of the controller: pen state, scaling to
+ * the panel size, rotation and the optional nonlinearity correction.
+ */
+class TouchDecoder
+{
+public:
+
+    TouchDecoder()
+    {
+      _width = 0;
+      _height = 0;
+      _rotated = false;
+      _correction = NULL;
+    }
+
+    void init(uint16_t width, uint16_t height, bool rotated);
+    void setCorrection(TouchCorrection *correction);
+
+    bool decode(const uint8_t *packet, touchDecoded_t &out) const;
+
+private:
+
+    uint16_t _width;
+    uint16_t _height;
+    bool     _rotated;
+    TouchCorrection *_correction;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchDispatcher.h"
+
+
+/**
+ * Add a subscriber.
+ *
+ * @param callback function called for every selected event
+ * @param ctx passed unchanged to the callback
+ * @param priority subscribers with higher priority are called first
+ * @param mask combination of TOUCH_EVT_DOWN, TOUCH_EVT_UP, TOUCH_EVT_MOVE
+ * @param decimation only every n-th move event is delivered (0 or 1: all)
+ * @param mode TOUCH_DISPATCH_ISR or TOUCH_DISPATCH_DEFERRED
+ *
+ * @return false if the table is full
+ */
+bool TouchDispatcher::subscribe(dispatchCallback_t callback, void *ctx, uint8_t priority,
+                                uint8_t mask, uint8_t decimation, uint8_t mode)
+{
+  if (callback == NULL || _count >= TOUCH_DISPATCH_MAX_SUBSCRIBERS) return false;
+
+  // keep the table sorted by descending priority
+  uint8_t pos = _count;
+  while (pos > 0 && _subs[pos-1].priority < priority) {
+    _subs[pos] = _subs[pos-1];
+    pos--;
+  }
+
+  subscriber_t &s = _subs[pos];
+  s.callback = callback;
+  s.ctx = ctx;
+  s.priority = priority;
+  s.mask = mask;
+  s.decimation = (decimation == 0) ? 1 : decimation;
+  s.skipped = 0;
+  s.mode = mode;
+  _count++;
+
+  _deferredMask = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_subs[i].mode == TOUCH_DISPATCH_DEFERRED)
+      _deferredMask |= _subs[i].mask;
+  }
+  return true;
+}
+
+void TouchDispatcher::unsubscribe(dispatchCallback_t callback, void *ctx)
+{
+  uint8_t n = 0;
+  _deferredMask = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_subs[i].callback == callback && _subs[i].ctx == ctx)
+      continue;
+    _subs[n] = _subs[i];
+    if (_subs[n].mode == TOUCH_DISPATCH_DEFERRED)
+      _deferredMask |= _subs[n].mask;
+    n++;
+  }
+  _count = n;
+}
+
+/**
+ * Classify a decoded sample and deliver it. Subscribers in ISR mode are
+ * called immediately, the event is queued for deferred subscribers.
+ */
+void TouchDispatcher::publish(int16_t x, int16_t y, bool touched, uint16_t timestamp)
+{
+  dispatchEvent_t event;
+
+  if (touched && !_touched)
+    event.type = TOUCH_EVT_DOWN;
+  else if (!touched && _touched)
+    event.type = TOUCH_EVT_UP;
+  else if (touched && (x != _x || y != _y))
+    event.type = TOUCH_EVT_MOVE;
+  else
+    return;
+
+  _touched = touched;
+  _x = x;
+  _y = y;
+
+  event.x = x;
+  event.y = y;
+  event.timestamp = timestamp;
+
+  deliver(event, TOUCH_DISPATCH_ISR);
+
+  if (_deferredMask & event.type) {
+    uint8_t next = (_head + 1) % TOUCH_DISPATCH_QUEUE_SIZE;
+    if (next == _tail) {
+      queueOverflows++;
+    }
+    else {
+      _queue[_head] = event;
+      _head = next;
+    }
+  }
+}
+
+/**
+ * Deliver queued events to the deferred subscribers. Call this from the
+ * main loop.
+ */
+void TouchDispatcher::process()
+{
+  while (_tail != _head) {
+    deliver(_queue[_tail], TOUCH_DISPATCH_DEFERRED);
+    _tail = (_tail + 1) % TOUCH_DISPATCH_QUEUE_SIZE;
+  }
+}
+
+void TouchDispatcher::deliver(const dispatchEvent_t &event, uint8_t mode)
+{
+  for (uint8_t i = 0; i < _count; i++) {
+    subscriber_t &s = _subs[i];
+    if (s.mode != mode || !(s.mask & event.type)) continue;
+
+    if (event.type == TOUCH_EVT_MOVE) {
+      if (++s.skipped < s.decimation) continue;
+      s.skipped = 0;
+    }
+    s.callback(event, s.ctx);
+  }
+}
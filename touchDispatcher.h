@@ -0,0 +1,108 @@
+/*
+ *  Fan-out of touch events to several subscribers.
+ *
+ *  Subscribers are kept in a fixed table sorted by priority. Each one
+ *  selects the event types it wants, may skip move events by decimation
+ *  and is either called directly from publish() (which runs in the touch
+ *  interrupt when fed by the AR1021 driver) or deferred from process()
+ *  in the main loop.
+ */
+
+#ifndef TOUCHDISPATCHER_H
+#define TOUCHDISPATCHER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#ifndef TOUCH_DISPATCH_MAX_SUBSCRIBERS
+#define TOUCH_DISPATCH_MAX_SUBSCRIBERS (4)
+#endif
+
+// events waiting for deferred subscribers (max. 255)
+#ifndef TOUCH_DISPATCH_QUEUE_SIZE
+#define TOUCH_DISPATCH_QUEUE_SIZE (8)
+#endif
+
+#define TOUCH_EVT_DOWN (0x01)
+#define TOUCH_EVT_UP   (0x02)
+#define TOUCH_EVT_MOVE (0x04)
+#define TOUCH_EVT_ALL  (TOUCH_EVT_DOWN|TOUCH_EVT_UP|TOUCH_EVT_MOVE)
+
+#define TOUCH_DISPATCH_ISR      (0)
+#define TOUCH_DISPATCH_DEFERRED (1)
+
+typedef struct
+{
+    uint8_t  type;
+    int16_t  x;
+    int16_t  y;
+    uint16_t timestamp;
+} dispatchEvent_t;
+
+typedef void (*dispatchCallback_t)(const dispatchEvent_t &event, void *ctx);
+
+
+/**
+ * Subscribing and unsubscribing must not happen while publish() can run,
+ * i.e. do it during setup or with the touch interrupt disabled.
+ * publish() must always be called from the same context, e.g. only from
+ * the touch interrupt through AR1021::setDispatcher(). process() is the
+ * only reader of the queue and must be called from one context as well.
+ */
+class TouchDispatcher
+{
+public:
+
+    TouchDispatcher()
+    {
+      _count = 0;
+      _deferredMask = 0;
+      _touched = false;
+      _x = _y = 0;
+      _head = _tail = 0;
+      queueOverflows = 0;
+    }
+
+    bool subscribe(dispatchCallback_t callback, void *ctx, uint8_t priority,
+                   uint8_t mask, uint8_t decimation, uint8_t mode);
+    void unsubscribe(dispatchCallback_t callback, void *ctx);
+
+    void publish(int16_t x, int16_t y, bool touched, uint16_t timestamp);
+    void process();
+
+    uint16_t queueOverflows;
+
+private:
+
+    typedef struct
+    {
+        dispatchCallback_t callback;
+        void   *ctx;
+        uint8_t priority;
+        uint8_t mask;
+        uint8_t decimation;
+        uint8_t skipped;
+        uint8_t mode;
+    } subscriber_t;
+
+    subscriber_t _subs[TOUCH_DISPATCH_MAX_SUBSCRIBERS];
+    uint8_t _count;
+    uint8_t _deferredMask;
+
+    bool    _touched;
+    int16_t _x, _y;
+
+    dispatchEvent_t  _queue[TOUCH_DISPATCH_QUEUE_SIZE];
+    volatile uint8_t _head;
+    volatile uint8_t _tail;
+
+    void deliver(const dispatchEvent_t &event, uint8_t mode);
+};
+
+#endif
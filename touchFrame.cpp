@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchFrame.h"
+
+
+uint8_t touchFrameCrc(const uint8_t *data, uint8_t len)
+{
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+
+void TouchFrameDecoder::reset()
+{
+  _len = 0;
+  _haveSeq = false;
+  _lastSeq = 0;
+  framesOk = framesBad = framesLost = 0;
+}
+
+void TouchFrameDecoder::feed(const uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    if (_len == 0 && data[i] != TOUCH_FRAME_SYNC)
+      continue;
+    _buf[_len++] = data[i];
+    scan();
+  }
+}
+
+/**
+ * Check the buffered bytes. After a bad header or crc the bytes following
+ * the sync are searched for the next sync again, so a stray sync byte
+ * does not swallow the frame after it.
+ */
+void TouchFrameDecoder::scan()
+{
+  while (_len > 0) {
+    if (_len < 2) return;
+
+    uint8_t count = _buf[1] & TOUCH_FRAME_COUNT_MASK;
+    if (count == 0 || count > TOUCH_FRAME_MAX_SAMPLES) {
+      framesBad++;
+      resync();
+      continue;
+    }
+
+    uint8_t expected = 2 + ((_buf[1] & TOUCH_FRAME_SEQ_FLAG) ? 1 : 0) + 2
+                     + count*TOUCH_FRAME_SAMPLE_BYTES + 1;
+    if (_len < expected) return;
+
+    if (touchFrameCrc(_buf, expected-1) != _buf[expected-1]) {
+      framesBad++;
+      resync();
+      continue;
+    }
+
+    process();
+    _len = 0;
+  }
+}
+
+// drop the sync at the start and everything up to the next sync
+void TouchFrameDecoder::resync()
+{
+  uint8_t k = 1;
+  while (k < _len && _buf[k] != TOUCH_FRAME_SYNC) k++;
+  for (uint8_t i = k; i < _len; i++)
+    _buf[i-k] = _buf[i];
+  _len -= k;
+}
+
+void TouchFrameDecoder::process()
+{
+  framesOk++;
+
+  uint8_t count = _buf[1] & TOUCH_FRAME_COUNT_MASK;
+  uint8_t pos = 2;
+
+  if (_buf[1] & TOUCH_FRAME_SEQ_FLAG) {
+    uint8_t seq = _buf[pos++];
+    if (_haveSeq)
+      framesLost += (uint8_t)(seq - _lastSeq - 1);
+    _lastSeq = seq;
+    _haveSeq = true;
+  }
+
+  touchEvent_t event;
+  event.timestamp = _buf[pos] | ((uint16_t)_buf[pos+1] << 8);
+  pos += 2;
+
+  for (uint8_t i = 0; i < count; i++) {
+    event.timestamp += _buf[pos];
+    event.x = _buf[pos+1] | ((uint16_t)(_buf[pos+2] & ~TOUCH_FRAME_PEN_FLAG) << 8);
+    event.touched = (_buf[pos+2] & TOUCH_FRAME_PEN_FLAG) != 0;
+    event.y = _buf[pos+3] | ((uint16_t)_buf[pos+4] << 8);
+    pos += TOUCH_FRAME_SAMPLE_BYTES;
+    if (_onEvent != NULL) _onEvent(event, _ctx);
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ *  Binary touch event frames.
+ *
+ *  Frame layout
+ *  ------------
+ *  0      TOUCH_FRAME_SYNC
+ *  1      bit 0..5 number of samples (1..TOUCH_FRAME_MAX_SAMPLES)
+ *         bit 7    sequence number present
+ *  (2)    sequence number, increments with every frame
+ *  +0,+1  timestamp of the first sample in ms (little endian)
+ *  then per sample 5 bytes:
+ *         dt   ms since the previous sample of this frame (0 for the first)
+ *         xlo, xhi  x coordinate (0..32767), bit 7 of xhi is the pen
+ *                   state (1 = down)
+ *         ylo, yhi  y coordinate
+ *  last   CRC-8 (poly 0x07) over all preceding bytes including the sync
+ */
+
+#ifndef TOUCHFRAME_H
+#define TOUCHFRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#define TOUCH_FRAME_SYNC         (0xA5)
+#define TOUCH_FRAME_SEQ_FLAG     (0x80)
+#define TOUCH_FRAME_COUNT_MASK   (0x3F)
+#define TOUCH_FRAME_PEN_FLAG     (0x80)
+#define TOUCH_FRAME_SAMPLE_BYTES (5)
+
+#ifndef TOUCH_FRAME_MAX_SAMPLES
+#define TOUCH_FRAME_MAX_SAMPLES  (12)
+#endif
+
+#if TOUCH_FRAME_MAX_SAMPLES > TOUCH_FRAME_COUNT_MASK
+#error "TOUCH_FRAME_MAX_SAMPLES must not exceed 63"
+#endif
+
+// sync, header, sequence, timestamp, samples, crc
+#define TOUCH_FRAME_MAX_BYTES (1+1+1+2+TOUCH_FRAME_MAX_SAMPLES*TOUCH_FRAME_SAMPLE_BYTES+1)
+
+typedef struct
+{
+    uint16_t timestamp;
+    int16_t  x;
+    int16_t  y;
+    bool     touched;
+} touchEvent_t;
+
+
+uint8_t touchFrameCrc(const uint8_t *data, uint8_t len);
+
+
+/**
+ * Streaming decoder for touch frames. Bytes may be fed in chunks of any
+ * size; invalid frames are skipped and the decoder resynchronizes on the
+ * next sync byte.
+ */
+class TouchFrameDecoder
+{
+public:
+
+    typedef void (*eventCallback_t)(const touchEvent_t &event, void *ctx);
+
+    TouchFrameDecoder(eventCallback_t onEvent, void *ctx)
+    {
+      _onEvent = onEvent;
+      _ctx = ctx;
+      reset();
+    }
+
+    void reset();
+    void feed(const uint8_t *data, size_t len);
+
+    uint16_t framesOk;
+    uint16_t framesBad;     // crc or format errors
+    uint16_t framesLost;    // gaps detected through the sequence number
+
+private:
+
+    eventCallback_t _onEvent;
+    void           *_ctx;
+
+    uint8_t _buf[TOUCH_FRAME_MAX_BYTES];
+    uint8_t _len;
+    bool    _haveSeq;
+    uint8_t _lastSeq;
+
+    void scan();
+    void resync();
+    void process();
+};
+
+#endif
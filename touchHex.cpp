@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchHex.h"
+
+
+/**
+ * Write len bytes as upper case hex digits.
+ *
+ * @param text buffer of at least 2*len+1 characters, zero terminated
+ */
+void touchHexEncode(const uint8_t *data, uint8_t len, char *text)
+{
+  static const char hex[] = "0123456789ABCDEF";
+
+  for (uint8_t i = 0; i < len; i++) {
+    text[2*i]   = hex[data[i] >> 4];
+    text[2*i+1] = hex[data[i] & 0x0F];
+  }
+  text[2*len] = 0;
+}
+
+static int8_t hexDigit(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Decode pairs of hex digits until the first character which is not a
+ * hex digit.
+ *
+ * @return number of bytes written to data
+ */
+uint16_t touchHexDecode(const char *text, uint8_t *data, uint16_t maxLen)
+{
+  uint16_t n = 0;
+
+  while (n < maxLen) {
+    int8_t hi = hexDigit(text[2*n]);
+    if (hi < 0) break;
+    int8_t lo = hexDigit(text[2*n+1]);
+    if (lo < 0) break;
+    data[n++] = (hi << 4) | lo;
+  }
+  return n;
+}
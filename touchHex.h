@@ -0,0 +1,16 @@
+/*
+ *  Hex encoding of binary data for text channels such as
+ *  Communication::sendInfo().
+ */
+
+#ifndef TOUCHHEX_H
+#define TOUCHHEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+void touchHexEncode(const uint8_t *data, uint8_t len, char *text);
+uint16_t touchHexDecode(const char *text, uint8_t *data, uint16_t maxLen);
+
+#endif
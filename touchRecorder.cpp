@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchRecorder.h"
+
+
+void TouchRecorder::start()
+{
+  _enabled = true;
+}
+
+void TouchRecorder::stop()
+{
+  _enabled = false;
+}
+
+void TouchRecorder::clear()
+{
+  bool enabled = _enabled;
+  _enabled = false;
+  _len = 0;
+  _dropped = 0;
+  _enabled = enabled;
+}
+
+uint16_t TouchRecorder::length() const
+{
+  uint16_t len;
+  // 16-bit read is not atomic on AVR, read again if a record came in between
+  do {
+    len = _len;
+  } while (len != _len);
+  return len;
+}
+
+uint16_t TouchRecorder::dropped() const
+{
+  uint16_t n;
+  do {
+    n = _dropped;
+  } while (n != _dropped);
+  return n;
+}
+
+uint8_t *TouchRecorder::reserve(uint8_t type, uint16_t timestamp, uint8_t payloadLen)
+{
+  if (!_enabled) return NULL;
+
+  uint16_t pos = _len;
+  if (pos + TOUCH_REC_HDR_BYTES + payloadLen > TOUCH_RECORDER_SIZE) {
+    _dropped++;
+    return NULL;
+  }
+  _buf[pos]   = type | payloadLen;
+  _buf[pos+1] = timestamp & 0xFF;
+  _buf[pos+2] = timestamp >> 8;
+  return &_buf[pos+TOUCH_REC_HDR_BYTES];
+}
+
+// make the record written after reserve() visible to length()
+void TouchRecorder::commit(uint8_t payloadLen)
+{
+  _len = _len + TOUCH_REC_HDR_BYTES + payloadLen;
+}
+
+void TouchRecorder::recordPacket(uint16_t timestamp, const uint8_t *packet)
+{
+  uint8_t *p = reserve(TOUCH_REC_PACKET, timestamp, TOUCH_REC_PACKET_BYTES);
+  if (p == NULL) return;
+  for (uint8_t i = 0; i < TOUCH_REC_PACKET_BYTES; i++)
+    p[i] = packet[i];
+  commit(TOUCH_REC_PACKET_BYTES);
+}
+
+void TouchRecorder::recordCommand(uint16_t timestamp, uint8_t cmd, int16_t result,
+                                  const uint8_t *resp, uint8_t respLen)
+{
+  if (resp == NULL) respLen = 0;
+  if (respLen > TOUCH_REC_MAX_RESP) respLen = TOUCH_REC_MAX_RESP;
+
+  uint8_t *p = reserve(TOUCH_REC_CMD, timestamp, 3 + respLen);
+  if (p == NULL) return;
+  p[0] = cmd;
+  p[1] = result & 0xFF;
+  p[2] = (uint16_t)result >> 8;
+  for (uint8_t i = 0; i < respLen; i++)
+    p[3+i] = resp[i];
+  commit(3 + respLen);
+}
+
+void TouchReplay::setSpeed(uint8_t speedShift)
+{
+  if (speedShift > TOUCH_REPLAY_MAX_SHIFT && speedShift != TOUCH_REPLAY_NO_DELAY)
+    speedShift = TOUCH_REPLAY_MAX_SHIFT;
+  _speedShift = speedShift;
+}
+
+void TouchReplay::rewind()
+{
+  _pos = 0;
+  _started = false;
+}
+
+bool TouchReplay::peek(touchRecord_t &record)
+{
+  if (_pos + TOUCH_REC_HDR_BYTES > _len) return false;
+
+  record.type = _data[_pos] & TOUCH_REC_TYPE_MASK;
+  record.len = _data[_pos] & TOUCH_REC_LEN_MASK;
+  record.timestamp = _data[_pos+1] | ((uint16_t)_data[_pos+2] << 8);
+  record.payload = &_data[_pos+TOUCH_REC_HDR_BYTES];
+
+  // truncated recording
+  if (_pos + TOUCH_REC_HDR_BYTES + record.len > _len) return false;
+  return true;
+}
+
+bool TouchReplay::next(touchRecord_t &record)
+{
+  if (!peek(record)) {
+    _pos = _len;
+    return false;
+  }
+  _pos += TOUCH_REC_HDR_BYTES + record.len;
+  return true;
+}
+
+/**
+ * Deliver all records which are due at the given time.
+ *
+ * @param now current time in the same unit as the recorded timestamps
+ *
+ * @return number of records delivered
+ */
+uint16_t TouchReplay::poll(uint16_t now)
+{
+  touchRecord_t record;
+  uint16_t delivered = 0;
+
+  while (peek(record)) {
+    if (!_started) {
+      _startNow = now;
+      _startRecorded = record.timestamp;
+      _started = true;
+    }
+
+    if (_speedShift != TOUCH_REPLAY_NO_DELAY) {
+      uint16_t due = (uint16_t)(record.timestamp - _startRecorded) >> _speedShift;
+      if ((uint16_t)(now - _startNow) < due) break;
+    }
+
+    next(record);
+    if (_onRecord != NULL) _onRecord(record, _ctx);
+    delivered++;
+  }
+
+  if (!peek(record)) _pos = _len;
+  return delivered;
+}
@@ -0,0 +1,144 @@
+/*
+ *  Recording and replay of the raw traffic of the AR1021.
+ *
+ *  Record layout
+ *  -------------
+ *  0      bit 6..7 record type, bit 0..5 payload length
+ *  1,2    timestamp in driver ticks (little endian)
+ *  then the payload:
+ *         TOUCH_REC_PACKET  the 5-byte touch packet
+ *         TOUCH_REC_CMD     cmd, result (int16, little endian), response bytes
+ */
+
+#ifndef TOUCHRECORDER_H
+#define TOUCHRECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#ifndef TOUCH_RECORDER_SIZE
+#define TOUCH_RECORDER_SIZE (512)
+#endif
+
+#define TOUCH_REC_PACKET (0x40)
+#define TOUCH_REC_CMD    (0x80)
+
+#define TOUCH_REC_TYPE_MASK (0xC0)
+#define TOUCH_REC_LEN_MASK  (0x3F)
+#define TOUCH_REC_HDR_BYTES (3)
+
+#define TOUCH_REC_PACKET_BYTES (5)
+#define TOUCH_REC_MAX_RESP     (TOUCH_REC_LEN_MASK-3)
+
+// replay as fast as possible, ignoring the timestamps
+#define TOUCH_REPLAY_NO_DELAY  (0xFF)
+// largest acceleration, timestamps are 16 bit
+#define TOUCH_REPLAY_MAX_SHIFT (15)
+
+typedef struct
+{
+    uint8_t        type;
+    uint16_t       timestamp;
+    uint8_t        len;
+    const uint8_t *payload;
+} touchRecord_t;
+
+
+/**
+ * Captures touch packets and command responses into a fixed buffer.
+ * Recording stops when the buffer is full; the number of dropped records
+ * is counted.
+ *
+ * recordPacket() may be called from interrupt context. recordCommand()
+ * must not be interrupted by recordPacket(); the AR1021 driver calls it
+ * with interrupts disabled. length() and dropped() may be called while
+ * recording, the bytes up to length() are complete records.
+ */
+class TouchRecorder
+{
+public:
+
+    TouchRecorder()
+    {
+      _len = 0;
+      _enabled = false;
+      _dropped = 0;
+    }
+
+    void start();
+    void stop();
+    void clear();
+
+    void recordPacket(uint16_t timestamp, const uint8_t *packet);
+    void recordCommand(uint16_t timestamp, uint8_t cmd, int16_t result,
+                       const uint8_t *resp, uint8_t respLen);
+
+    const uint8_t *data() const { return _buf; }
+    uint16_t length() const;
+    uint16_t dropped() const;
+
+private:
+
+    uint8_t  _buf[TOUCH_RECORDER_SIZE];
+    volatile uint16_t _len;
+    volatile uint16_t _dropped;
+    volatile bool     _enabled;
+
+    uint8_t *reserve(uint8_t type, uint16_t timestamp, uint8_t payloadLen);
+    void commit(uint8_t payloadLen);
+};
+
+
+/**
+ * Replays a recording. Records are delivered through callbacks when they
+ * are due according to their timestamps, optionally accelerated by
+ * 2^speedShift. Touch packets are meant to be passed to
+ * TouchDecoder::decode(), which is the decoding the driver uses for
+ * packets read over SPI, or back into the driver itself as the host
+ * harness does (host/driverReplay.h).
+ */
+class TouchReplay
+{
+public:
+
+    typedef void (*recordCallback_t)(const touchRecord_t &record, void *ctx);
+
+    TouchReplay(const uint8_t *data, uint16_t len, recordCallback_t onRecord, void *ctx)
+    {
+      _data = data;
+      _len = len;
+      _onRecord = onRecord;
+      _ctx = ctx;
+      _speedShift = 0;
+      rewind();
+    }
+
+    void setSpeed(uint8_t speedShift);
+    void rewind();
+    bool next(touchRecord_t &record);
+    uint16_t poll(uint16_t now);
+    bool finished() const { return _pos >= _len; }
+
+private:
+
+    const uint8_t   *_data;
+    uint16_t         _len;
+    recordCallback_t _onRecord;
+    void            *_ctx;
+    uint8_t          _speedShift;
+
+    uint16_t _pos;
+    bool     _started;
+    uint16_t _startNow;
+    uint16_t _startRecorded;
+
+    bool peek(touchRecord_t &record);
+};
+
+#endif
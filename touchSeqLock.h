@@ -0,0 +1,81 @@
+/*
+ *  Sequence counter for data written by one interrupt and read by the
+ *  main context without disabling interrupts.
+ *
+ *  The writer makes the counter odd, updates the data and makes it even
+ *  again. A reader copies the data between readBegin() and readRetry()
+ *  and copies again when the counter was odd or has changed meanwhile.
+ *
+ *  There must be a single writer: two contexts incrementing the counter
+ *  can leave it even while one of them is still writing. The counter only
+ *  has to be wide enough that it cannot wrap around to the same value
+ *  during one copy; on the AVR a copy takes a few microseconds, so 8 bits
+ *  are plenty.
+ */
+
+#ifndef TOUCHSEQLOCK_H
+#define TOUCHSEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+#if defined(__AVR__)
+// single core, only the compiler must not move accesses across the counter
+#define TOUCH_SEQ_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+// the accesses must also be ordered between CPUs
+#define TOUCH_SEQ_BARRIER() __sync_synchronize()
+#endif
+
+
+template <class Counter>
+class TouchSeqLock
+{
+public:
+
+    TouchSeqLock()
+    {
+      _seq = 0;
+    }
+
+    void writeBegin()
+    {
+      _seq = _seq + 1;
+      TOUCH_SEQ_BARRIER();
+    }
+
+    void writeEnd()
+    {
+      TOUCH_SEQ_BARRIER();
+      _seq = _seq + 1;
+    }
+
+    // false while a write is in progress, the copy must not be used then
+    bool readBegin(Counter &seq) const
+    {
+      seq = _seq;
+      if (seq & 1) return false;
+      TOUCH_SEQ_BARRIER();
+      return true;
+    }
+
+    // true if the data copied since readBegin() may be inconsistent
+    bool readRetry(Counter seq) const
+    {
+      TOUCH_SEQ_BARRIER();
+      return seq != _seq;
+    }
+
+    Counter sequence() const { return _seq; }
+
+private:
+
+    volatile Counter _seq;
+};
+
+#endif
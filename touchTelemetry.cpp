@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+
+#include "touchTelemetry.h"
+
+
+void TouchTelemetry::setSink(frameSink_t sink, void *ctx)
+{
+  _sink = sink;
+  _sinkCtx = ctx;
+}
+
+void TouchTelemetry::setCommunication(Communication *com)
+{
+  _com = com;
+}
+
+void TouchTelemetry::setSequence(bool enable)
+{
+  flush();
+  _useSeq = enable;
+}
+
+void TouchTelemetry::setThresholds(uint8_t maxSamples, uint16_t maxAge)
+{
+  flush();
+  if (maxSamples == 0) maxSamples = 1;
+  if (maxSamples > TOUCH_FRAME_MAX_SAMPLES) maxSamples = TOUCH_FRAME_MAX_SAMPLES;
+  _maxSamples = maxSamples;
+  _maxAge = maxAge;
+}
+
+void TouchTelemetry::addSample(uint16_t now, int16_t x, int16_t y, bool touched)
+{
+  // the time delta of a sample must fit into one byte
+  if (_count > 0 && (uint16_t)(now - _lastTime) > 0xFF)
+    flush();
+
+  if (_count == 0) {
+    _len = 0;
+    _frame[_len++] = TOUCH_FRAME_SYNC;
+    _frame[_len++] = 0;     // header, set in flush()
+    if (_useSeq)
+      _frame[_len++] = _seq;
+    _frame[_len++] = now & 0xFF;
+    _frame[_len++] = now >> 8;
+    _firstTime = now;
+    _lastTime = now;
+  }
+
+  if (x < 0) x = 0;
+
+  _frame[_len++] = (uint8_t)(now - _lastTime);
+  _frame[_len++] = x & 0xFF;
+  _frame[_len++] = ((x >> 8) & ~TOUCH_FRAME_PEN_FLAG) | (touched ? TOUCH_FRAME_PEN_FLAG : 0);
+  _frame[_len++] = y & 0xFF;
+  _frame[_len++] = y >> 8;
+  _lastTime = now;
+  _count++;
+
+  if (_count >= _maxSamples)
+    flush();
+}
+
+void TouchTelemetry::poll(uint16_t now)
+{
+  if (_count > 0 && (uint16_t)(now - _firstTime) >= _maxAge)
+    flush();
+}
+
+void TouchTelemetry::flush()
+{
+  if (_count == 0) return;
+
+  _frame[1] = _count | (_useSeq ? TOUCH_FRAME_SEQ_FLAG : 0);
+  _frame[_len] = touchFrameCrc(_frame, _len);
+  _len++;
+
+  send(_frame, _len);
+
+  if (_useSeq) _seq++;
+  framesSent++;
+  _count = 0;
+}
+
+void TouchTelemetry::send(const uint8_t *frame, uint8_t len)
+{
+  if (_sink != NULL) {
+    _sink(frame, len, _sinkCtx);
+  }
+  else if (_com != NULL) {
+    char text[2*TOUCH_FRAME_MAX_BYTES+1];
+    touchHexEncode(frame, len, text);
+    _com->sendInfo(text, "BT");
+  }
+}
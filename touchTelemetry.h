@@ -0,0 +1,84 @@
+/*
+ *  Batched transmission of touch events as binary frames (see touchFrame.h).
+ */
+
+#ifndef TOUCHTELEMETRY_H
+#define TOUCHTELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "touchFrame.h"
+#include "touchHex.h"
+#include "Communication.h"
+
+
+/******************************************************************************
+ * Defines and typedefs
+ *****************************************************************************/
+
+// default age of the oldest sample in ms after which a frame is sent
+#define TOUCH_TELEMETRY_DEFAULT_MAX_AGE (50)
+
+
+/**
+ * Collects touch samples into frames and sends them when the frame is
+ * full or when the oldest sample is older than the configured age.
+ *
+ * Frames are handed to the sink set with setSink(). Without a sink the
+ * frames are sent hex encoded with Communication::sendInfo().
+ *
+ * x is clamped to 0..32767 since bit 15 carries the pen state.
+ */
+class TouchTelemetry
+{
+public:
+
+    typedef void (*frameSink_t)(const uint8_t *frame, uint8_t len, void *ctx);
+
+    TouchTelemetry()
+    {
+      _sink = NULL;
+      _sinkCtx = NULL;
+      _com = NULL;
+      _useSeq = true;
+      _seq = 0;
+      _maxSamples = TOUCH_FRAME_MAX_SAMPLES;
+      _maxAge = TOUCH_TELEMETRY_DEFAULT_MAX_AGE;
+      _count = 0;
+      framesSent = 0;
+    }
+
+    void setSink(frameSink_t sink, void *ctx);
+    void setCommunication(Communication *com);
+    void setSequence(bool enable);
+    void setThresholds(uint8_t maxSamples, uint16_t maxAge);
+
+    void addSample(uint16_t now, int16_t x, int16_t y, bool touched);
+    void poll(uint16_t now);
+    void flush();
+
+    uint16_t framesSent;
+
+private:
+
+    frameSink_t    _sink;
+    void          *_sinkCtx;
+    Communication *_com;
+
+    bool     _useSeq;
+    uint8_t  _seq;
+    uint8_t  _maxSamples;
+    uint16_t _maxAge;
+
+    uint8_t  _frame[TOUCH_FRAME_MAX_BYTES];
+    uint8_t  _len;
+    uint8_t  _count;
+    uint16_t _firstTime;
+    uint16_t _lastTime;
+
+    void send(const uint8_t *frame, uint8_t len);
+};
+
+#endif